@@ -0,0 +1,98 @@
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// Core
+#include "Core/CollisionMask.h"
+#include "Core/SpriteComparisonUtils.h"
+#include "Core/RandomUtils.h"
+
+// System
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+CollisionMask CreateEllipseMask(const sf::Vector2u& size)
+{
+    sf::Image image;
+    image.create(size, sf::Color::Transparent);
+
+    sf::Vector2f radius = sf::Vector2f(size) / 2.0f;
+    for (uint32_t y = 0; y < size.y; y++)
+    {
+        for (uint32_t x = 0; x < size.x; x++)
+        {
+            float dx = (x + 0.5f - radius.x) / radius.x;
+            float dy = (y + 0.5f - radius.y) / radius.y;
+            if (dx * dx + dy * dy <= 1.0f)
+            {
+                image.setPixel({ x, y }, sf::Color::White);
+            }
+        }
+    }
+
+    return CollisionMask(image, sf::IntRect({ 0, 0 }, sf::Vector2i(size)));
+}
+
+//------------------------------------------------------------------------------
+struct CandidatePair
+{
+    sf::Transformable mBullet;
+    sf::Transformable mTarget;
+};
+
+//------------------------------------------------------------------------------
+template<typename CompareFunction>
+void RunBenchmark(const std::string& name, const std::vector<CandidatePair>& pairs, uint32_t iterations, CompareFunction compare)
+{
+    uint32_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+        for (const CandidatePair& pair : pairs)
+        {
+            hits += compare(pair) ? 1 : 0;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    double tests = static_cast<double>(pairs.size()) * iterations;
+
+    std::cout << name << ": " << nanoseconds / tests << " ns/test, " << hits << " hits\n";
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    const uint32_t PAIR_COUNT = 4096;
+    const uint32_t ITERATIONS = 50;
+
+    // Roughly the bullet and enemy sprite footprints, placed so their AABBs overlap
+    CollisionMask bulletMask = CreateEllipseMask({ 24, 12 });
+    CollisionMask targetMask = CreateEllipseMask({ 80, 112 });
+
+    std::vector<CandidatePair> pairs(PAIR_COUNT);
+    for (CandidatePair& pair : pairs)
+    {
+        pair.mTarget.setPosition({ 0.0f, 0.0f });
+        pair.mTarget.setScale({ GetRandomIntegerFromList({ -1.0f, 1.0f }), 1.0f });
+        pair.mTarget.setOrigin({ pair.mTarget.getScale().x < 0.0f ? 80.0f : 0.0f, 0.0f });
+        pair.mBullet.setOrigin({ 12.0f, 6.0f });
+        pair.mBullet.setPosition({ RandomFloat(-12.0f, 92.0f), RandomFloat(-6.0f, 118.0f) });
+    }
+
+    RunBenchmark("Per pixel transform (previous BitmaskCompare)", pairs, ITERATIONS, [&](const CandidatePair& pair)
+    {
+        return CompareMaskPixels(bulletMask, pair.mBullet.getTransform(), targetMask, pair.mTarget.getTransform());
+    });
+
+    RunBenchmark("Row words (BitmaskCompare)", pairs, ITERATIONS, [&](const CandidatePair& pair)
+    {
+        return BitmaskCompare(bulletMask, pair.mBullet, targetMask, pair.mTarget);
+    });
+
+    return 0;
+}
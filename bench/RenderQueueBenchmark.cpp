@@ -0,0 +1,100 @@
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// Core
+#include "Core/RenderQueue.h"
+#include "Core/RandomUtils.h"
+
+// System
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Stand-in for a drawn object, textures are only compared by address so they are never loaded
+struct StressSprite
+{
+    sf::Sprite mSprite;
+    sf::Transformable mTransformable;
+    uint32_t mDepth;
+};
+
+//------------------------------------------------------------------------------
+void AddSprites(std::vector<StressSprite>& sprites, uint32_t count, const std::vector<const sf::Texture*>& frames,
+                const sf::IntRect& textureRect, uint32_t depth)
+{
+    for (uint32_t index = 0; index < count; index++)
+    {
+        StressSprite stressSprite{ sf::Sprite(*frames[index % frames.size()], textureRect), sf::Transformable(), depth };
+        stressSprite.mTransformable.setPosition({ RandomFloat(0.0f, 4000.0f), RandomFloat(0.0f, 3000.0f) });
+        sprites.push_back(std::move(stressSprite));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Hundreds of enemies and bullets in the draw group order a level builds them in
+std::vector<StressSprite> CreateStressScene(const std::vector<const sf::Texture*>& enemyFrames, const std::vector<const sf::Texture*>& bulletFrames,
+                                            const std::vector<const sf::Texture*>& fireFrames, const sf::Texture& tileset)
+{
+    const uint32_t LEVEL_DEPTH = 2;
+
+    std::vector<StressSprite> sprites;
+    AddSprites(sprites, 1, enemyFrames, sf::IntRect({ 0, 0 }, { 92, 124 }), LEVEL_DEPTH);
+    AddSprites(sprites, 300, enemyFrames, sf::IntRect({ 0, 0 }, { 96, 112 }), LEVEL_DEPTH);
+    AddSprites(sprites, 20, { &tileset }, sf::IntRect({ 0, 0 }, { 192, 56 }), LEVEL_DEPTH);
+    AddSprites(sprites, 600, bulletFrames, sf::IntRect({ 0, 0 }, { 20, 12 }), LEVEL_DEPTH);
+    AddSprites(sprites, 100, fireFrames, sf::IntRect({ 0, 0 }, { 31, 20 }), LEVEL_DEPTH);
+    return sprites;
+}
+
+//------------------------------------------------------------------------------
+void RunBenchmark(const std::string& name, const std::vector<StressSprite>& sprites, uint32_t iterations)
+{
+    RenderQueue renderQueue;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+        renderQueue.Clear();
+        for (const StressSprite& stressSprite : sprites)
+        {
+            renderQueue.Submit(stressSprite.mDepth, stressSprite.mSprite, stressSprite.mTransformable.getTransform());
+        }
+        renderQueue.Sort();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double microseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+    // Draw issues exactly one call per batch, so the batch count is the batched draw call count. Batch
+    // counts depend only on the scene. The time is CPU-side submit and sort, which the atlas is not
+    // expected to speed up - it saves draw calls and texture binds, and those are never issued here
+    std::cout << name << ": " << sprites.size() << " sprites (" << sprites.size() << " draw calls unbatched), " 
+              << renderQueue.GetStats().mBatchCount << " batches, " << microseconds / iterations << " us/frame to submit and sort\n";
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    const uint32_t ITERATIONS = 1000;
+
+    // Every frame in its own texture, the way sprites were loaded before the atlas
+    std::vector<sf::Texture> textures(12);
+    std::vector<const sf::Texture*> enemyFrames;
+    for (uint32_t index = 0; index < 6; index++)
+    {
+        enemyFrames.push_back(&textures[index]);
+    }
+    std::vector<const sf::Texture*> bulletFrames = { &textures[6] };
+    std::vector<const sf::Texture*> fireFrames = { &textures[7], &textures[8] };
+    const sf::Texture& tileset = textures[9];
+
+    RunBenchmark("Separate textures", CreateStressScene(enemyFrames, bulletFrames, fireFrames, tileset), ITERATIONS);
+
+    // Entity, bullet and fire frames sharing one atlas page
+    std::vector<const sf::Texture*> atlasPage = { &textures[10] };
+    RunBenchmark("Atlas", CreateStressScene(atlasPage, atlasPage, atlasPage, tileset), ITERATIONS);
+
+    return 0;
+}
@@ -15,6 +15,10 @@
 #include "Core/Animate.h"
 #include "Core/Events.h"
 #include "Core/GameObjectManager.h"
+#include "Core/CollisionMask.h"
+#include "Core/ObjectPool.h"
+#include "Core/TextureAtlas.h"
+#include "Core/RenderQueue.h"
 
 // System
 #include <iostream>
@@ -24,26 +28,39 @@ class Bullet : public GameObject
 {
 public:
     Bullet(const sf::Vector2f& position, const sf::Vector2f& direction, const sf::Color& tintColor)
-        : mSprite(LoadTexture(Resources::BulletTexture))
+        : mSprite(CreateSprite(LoadAtlasRegion(Resources::BulletTexture)))
+        , mCollisionMask(LoadCollisionMask(mSprite.getTexture(), mSprite.getTextureRect()))
         , mDirection(direction)
         , mDepth(LAYERS.at("Level"))
         , mSpeed(1200.0f)
         , mTimeToLiveInSeconds(0.0f)
     { 
         mSprite.setColor(tintColor);
+        SetLocalBounds(mSprite.getLocalBounds());
         SetOrigin(sf::Vector2f(mSprite.getTextureRect().getSize()) / 2.0f);
         SetPosition(position);
+        mPreviousPosition = position;
     }
 
-    virtual FloatRect GetGlobalBounds() const
+    virtual FloatRect GetHitbox() const
     {
-        return GetTransform().transformRect(mSprite.getLocalBounds());
+        return GetTransform().transformRect(sf::FloatRect(mCollisionMask.GetOpaqueBounds()));
+    }
+
+    // Hitbox at the start of the last update, the swept path runs from here to GetHitbox()
+    virtual FloatRect GetPreviousHitbox() const override
+    {
+        FloatRect previousHitbox = GetHitbox();
+        previousHitbox.MoveLeft(mPreviousPosition.x - GetPosition().x);
+        previousHitbox.MoveTop(mPreviousPosition.y - GetPosition().y);
+        return previousHitbox;
     }
 
     virtual uint32_t GetDepth() const { return mDepth; }
     
     virtual void Update(const sf::Time& timeslice) 
     { 
+        mPreviousPosition = GetPosition();
         sf::Vector2f newPosition = GetPosition() + mDirection * mSpeed * timeslice.asSeconds();
         SetPosition(newPosition);
 
@@ -61,22 +78,31 @@ public:
         target.draw(mSprite, statesCopy);
     }
 
+    virtual void SubmitDraw(RenderQueue& renderQueue) const override
+    {
+        renderQueue.Submit(GetDepth(), mSprite, GetTransform());
+    }
+
     const sf::Sprite& GetSprite() { return mSprite; }
 
+    const CollisionMask& GetCollisionMask() const { return mCollisionMask; }
+
 private:
     sf::Vector2f mDirection;
     float mSpeed;
     uint32_t mDepth;
     sf::Sprite mSprite;
+    const CollisionMask& mCollisionMask;
     float mTimeToLiveInSeconds;
+    sf::Vector2f mPreviousPosition;
 };
 
 //------------------------------------------------------------------------------
 class FireAnimation : public GameObject
 {
 public:
-    FireAnimation(uint32_t entityId, const sf::Vector2f& direction, const sf::Color& tintColor)
-        : mEntityId(entityId)
+    FireAnimation(EntityHandle entityHandle, const sf::Vector2f& direction, const sf::Color& tintColor)
+        : mEntityHandle(entityHandle)
         , mDirection(direction)
         , mDepth(LAYERS.at("Level"))
         , mSprite(LoadTexture(Resources::PlaceholderTexture))
@@ -86,21 +112,23 @@ public:
         CreateAnimation();
         SetAnimationFrame();        
         SetPositionWithOffset();        
+
+        EventQueue::Instance()->Subscribe(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE, this, mEntityHandle);
+    }
+
+    virtual ~FireAnimation()
+    {
+        EventQueue::Instance()->Unsubscribe(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE, this);
     }
 
     virtual void HandleEvent(Event* event) override
     {
-        if (event->IsType(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE) && event->IsFromSender(mEntityId))
+        if (event->IsType(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE) && event->IsFromSender(mEntityHandle))
         {
             Kill();
         }
     }
 
-    virtual FloatRect GetGlobalBounds() const
-    {
-        return GetTransform().transformRect(mSprite.getLocalBounds());
-    }
-
     virtual uint32_t GetDepth() const { return mDepth; }
 
     virtual void Update(const sf::Time& timeslice)
@@ -123,22 +151,29 @@ public:
         target.draw(mSprite, statesCopy);
     }
 
+    virtual void SubmitDraw(RenderQueue& renderQueue) const override
+    {
+        renderQueue.Submit(GetDepth(), mSprite, GetTransform());
+    }
+
 private:
     void CreateAnimation()
     {
         const std::string sequenceId = "fireAnimation";
 
-        auto textures = std::make_unique<std::vector<sf::Texture*>>();
-        textures->push_back(&LoadTexture(Resources::fireAnimationTexture0));
-        textures->push_back(&LoadTexture(Resources::fireAnimationTexture1));
+        std::vector<AtlasRegion> regions;
+        regions.push_back(LoadAtlasRegion(Resources::fireAnimationTexture0));
+        regions.push_back(LoadAtlasRegion(Resources::fireAnimationTexture1));
 
-        mAnimation.AddSequence({ sequenceId, std::move(textures) });
-        mAnimation.SetSequence(sequenceId);
+        mAnimation.SetSequence(mAnimation.AddSequence({ sequenceId, std::move(regions) }));
     }
 
     void SetAnimationFrame()
     {
-        mSprite.setTexture(mAnimation.GetTexture(), true);
+        const AtlasRegion& region = mAnimation.GetRegion();
+        mSprite.setTexture(*region.mTexture);
+        mSprite.setTextureRect(region.mTextureRect);
+        SetLocalBounds(mSprite.getLocalBounds());
         if (mDirection.x < 0.0f)
         {
             SetScale({ -1.0f, 1.0f });            
@@ -148,7 +183,7 @@ private:
 
     void SetPositionWithOffset()
     {
-        Entity* entity = static_cast<Entity*>(GameObjectManager::Instance().GetInstance(mEntityId));
+        Entity* entity = static_cast<Entity*>(GameObjectManager::Instance().GetInstance(mEntityHandle));
         if (entity)
         {
             sf::Vector2f positionOffset;
@@ -161,8 +196,27 @@ private:
 
     FloatRect mHitbox;
     Animation mAnimation;
-    uint32_t mEntityId;
+    EntityHandle mEntityHandle;
     sf::Vector2f mDirection;
     uint32_t mDepth;
     sf::Sprite mSprite;
+};
+
+//------------------------------------------------------------------------------
+// Bullets and muzzle flashes are created and killed every shot, so they recycle pool slots
+template<>
+struct PoolTraits<Bullet>
+{
+    static constexpr bool IS_POOLED = true;
+    static constexpr uint32_t CAPACITY = 256;
+    static constexpr const char* NAME = "Bullet";
+};
+
+//------------------------------------------------------------------------------
+template<>
+struct PoolTraits<FireAnimation>
+{
+    static constexpr bool IS_POOLED = true;
+    static constexpr uint32_t CAPACITY = 64;
+    static constexpr const char* NAME = "FireAnimation";
 };
\ No newline at end of file
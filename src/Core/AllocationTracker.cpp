@@ -0,0 +1,355 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "AllocationTracker.h"
+
+// System
+#include <cassert>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    // Only the owning thread writes, atomics let other threads sum them without a data race
+    struct ThreadCounters
+    {
+        std::atomic<uint64_t> mCount{ 0 };
+        std::atomic<uint64_t> mBytes{ 0 };
+        bool mIsRegistered = false;
+    };
+
+    thread_local ThreadCounters sThreadCounters;
+
+    // Fixed table, registering must not allocate. Unregistered threads fold their totals into
+    // sRetiredTotals so the registered totals never go backwards
+    std::mutex sRegistryMutex;
+    ThreadCounters* sRegisteredThreads[AllocationTracker::MAX_THREADS];
+    uint32_t sRegisteredThreadCount = 0;
+    AllocationStats sRetiredTotals;
+
+    AllocationStats sFrameStart;
+    AllocationStats sLastFrame;
+    AllocationZoneStats sZones[AllocationTracker::MAX_ZONES];
+    uint32_t sZoneCount = 0;
+
+    AllocationStats Subtract(const AllocationStats& end, const AllocationStats& start)
+    {
+        return { end.mCount - start.mCount, end.mBytes - start.mBytes };
+    }
+
+    AllocationStats Load(const ThreadCounters& counters)
+    {
+        return { counters.mCount.load(std::memory_order_relaxed), counters.mBytes.load(std::memory_order_relaxed) };
+    }
+
+    // Zones are keyed by the address of their name literal, linear since there are only a few
+    AllocationZoneStats* FindOrAddZone(const char* name)
+    {
+        for (uint32_t index = 0; index < sZoneCount; index++)
+        {
+            if (sZones[index].mName == name)
+            {
+                return &sZones[index];
+            }
+        }
+
+        if (sZoneCount == AllocationTracker::MAX_ZONES)
+        {
+            return nullptr;
+        }
+        sZones[sZoneCount].mName = name;
+        return &sZones[sZoneCount++];
+    }
+}
+
+#if TRACK_ALLOCATIONS
+//------------------------------------------------------------------------------
+namespace
+{
+    void Count(size_t size)
+    {
+        // Plain load and store, the owning thread is the only writer
+        sThreadCounters.mCount.store(sThreadCounters.mCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sThreadCounters.mBytes.store(sThreadCounters.mBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+
+    void* AlignedMalloc(size_t size, std::align_val_t alignment)
+    {
+        size_t alignmentBytes = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+        return _aligned_malloc(size == 0 ? 1 : size, alignmentBytes);
+#else
+        // aligned_alloc wants a whole number of alignment units
+        size_t roundedSize = ((size == 0 ? 1 : size) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+        return std::aligned_alloc(alignmentBytes, roundedSize);
+#endif
+    }
+
+    void AlignedFree(void* ptr)
+    {
+#ifdef _MSC_VER
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+//------------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+    Count(size);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+//------------------------------------------------------------------------------
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    Count(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+//------------------------------------------------------------------------------
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+//------------------------------------------------------------------------------
+// Over-aligned types, their memory comes from the aligned allocator and must go back to it
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    Count(size);
+
+    if (void* ptr = AlignedMalloc(size, alignment))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+//------------------------------------------------------------------------------
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+//------------------------------------------------------------------------------
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    Count(size);
+    return AlignedMalloc(size, alignment);
+}
+
+//------------------------------------------------------------------------------
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, alignment, tag);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+    AlignedFree(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    AlignedFree(ptr);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    AlignedFree(ptr);
+}
+#endif
+
+//------------------------------------------------------------------------------
+/*static*/ bool AllocationTracker::IsEnabled()
+{
+    return TRACK_ALLOCATIONS;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ AllocationStats AllocationTracker::GetThreadTotals()
+{
+    return Load(sThreadCounters);
+}
+
+//------------------------------------------------------------------------------
+/*static*/ AllocationStats AllocationTracker::GetRegisteredTotals()
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    AllocationStats totals = sRetiredTotals;
+    for (uint32_t index = 0; index < sRegisteredThreadCount; index++)
+    {
+        AllocationStats threadTotals = Load(*sRegisteredThreads[index]);
+        totals.mCount += threadTotals.mCount;
+        totals.mBytes += threadTotals.mBytes;
+    }
+    return totals;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ void AllocationTracker::RegisterThread()
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    if (sThreadCounters.mIsRegistered)
+    {
+        return;
+    }
+
+    assert(sRegisteredThreadCount < MAX_THREADS);
+    if (sRegisteredThreadCount < MAX_THREADS)
+    {
+        sRegisteredThreads[sRegisteredThreadCount++] = &sThreadCounters;
+        sThreadCounters.mIsRegistered = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+/*static*/ void AllocationTracker::UnregisterThread()
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    for (uint32_t index = 0; index < sRegisteredThreadCount; index++)
+    {
+        if (sRegisteredThreads[index] == &sThreadCounters)
+        {
+            AllocationStats threadTotals = Load(sThreadCounters);
+            sRetiredTotals.mCount += threadTotals.mCount;
+            sRetiredTotals.mBytes += threadTotals.mBytes;
+
+            sRegisteredThreads[index] = sRegisteredThreads[--sRegisteredThreadCount];
+            sThreadCounters.mIsRegistered = false;
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/*static*/ void AllocationTracker::BeginFrame()
+{
+    AllocationStats totals = GetRegisteredTotals();
+    sLastFrame = Subtract(totals, sFrameStart);
+    sFrameStart = totals;
+
+    for (uint32_t index = 0; index < sZoneCount; index++)
+    {
+        sZones[index].mLastFrame = sZones[index].mFrame;
+        sZones[index].mFrame = { };
+    }
+}
+
+//------------------------------------------------------------------------------
+/*static*/ AllocationStats AllocationTracker::GetLastFrameStats()
+{
+    return sLastFrame;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ uint32_t AllocationTracker::GetZoneCount()
+{
+    return sZoneCount;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ const AllocationZoneStats& AllocationTracker::GetZoneStats(uint32_t index)
+{
+    assert(index < sZoneCount);
+    return sZones[index];
+}
+
+//------------------------------------------------------------------------------
+AllocationZone::AllocationZone(const char* name, bool assertNoAllocations)
+    : mName(name)
+    , mStart(TRACK_ALLOCATIONS ? AllocationTracker::GetRegisteredTotals() : AllocationStats())
+    , mAssertNoAllocations(assertNoAllocations)
+{ }
+
+//------------------------------------------------------------------------------
+AllocationZone::~AllocationZone()
+{
+    if (!TRACK_ALLOCATIONS)
+    {
+        return;
+    }
+
+    AllocationStats allocations = Subtract(AllocationTracker::GetRegisteredTotals(), mStart);
+    assert(!mAssertNoAllocations || allocations.mCount == 0);
+
+    if (AllocationZoneStats* zone = FindOrAddZone(mName))
+    {
+        zone->mFrame.mCount += allocations.mCount;
+        zone->mFrame.mBytes += allocations.mBytes;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <cstdint>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+struct AllocationStats
+{
+    uint64_t mCount = 0;
+    uint64_t mBytes = 0;
+};
+
+//------------------------------------------------------------------------------
+struct AllocationZoneStats
+{
+    const char* mName = nullptr;
+    AllocationStats mFrame;         // Accumulated over the current frame so far
+    AllocationStats mLastFrame;
+};
+
+//------------------------------------------------------------------------------
+// Counts global operator new calls per thread when built with TRACK_ALLOCATIONS, every query returns
+// zeros otherwise. Frame and zone totals sum every registered thread, so work spread over the job
+// system is included. Threads outside the game loop, e.g. audio streaming, are left unregistered
+class AllocationTracker
+{
+public:
+    static constexpr uint32_t MAX_ZONES = 32;
+    static constexpr uint32_t MAX_THREADS = 64;
+
+    static bool IsEnabled();
+    static AllocationStats GetThreadTotals();
+    static AllocationStats GetRegisteredTotals();
+
+    // Registering twice is a no-op, a thread must unregister before it exits
+    static void RegisterThread();
+    static void UnregisterThread();
+
+    static void BeginFrame();
+    static AllocationStats GetLastFrameStats();
+
+    static uint32_t GetZoneCount();
+    static const AllocationZoneStats& GetZoneStats(uint32_t index);
+};
+
+//------------------------------------------------------------------------------
+// Scoped profiler zone, adds the allocations every registered thread made while it is alive to the
+// zone named by the literal name. Zones are opened on the main thread only. With assertNoAllocations
+// set, any allocation inside the scope trips an assert
+class AllocationZone
+{
+public:
+    explicit AllocationZone(const char* name, bool assertNoAllocations = false);
+    ~AllocationZone();
+
+    AllocationZone(const AllocationZone&) = delete;
+    AllocationZone& operator=(const AllocationZone&) = delete;
+
+private:
+    const char* mName;
+    AllocationStats mStart;
+    bool mAssertNoAllocations;
+};
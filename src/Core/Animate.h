@@ -5,27 +5,44 @@
 // Third party
 #include <SFML/Graphics.hpp>
 
+// Core
+#include "CollisionMask.h"
+#include "TextureAtlas.h"
+
 // System
-#include <memory>
 #include <string>
+#include <cmath>
+#include <vector>
+#include <optional>
 
 //------------------------------------------------------------------------------
+// Frames are atlas regions, so every frame of a sequence usually shares one page texture
 class AnimationSequence
 {
 public:
-    AnimationSequence(const std::string& sequenceId, std::unique_ptr<std::vector<sf::Texture*>> sequence)
+    AnimationSequence(const std::string& sequenceId, std::vector<AtlasRegion> sequence)
         : mSequenceId(sequenceId)
         , mSequence(std::move(sequence))
-    { }
+    {
+        for (const AtlasRegion& region : mSequence)
+        {
+            mCollisionMasks.push_back(&LoadCollisionMask(*region.mTexture, region.mTextureRect));
+        }
+    }
 
-    const sf::Texture& GetTexture(uint32_t index) const
+    const AtlasRegion& GetRegion(uint32_t index) const
     {
-        return *(*mSequence)[index];
+        return mSequence[index];
+    }
+
+    const CollisionMask& GetCollisionMask(uint32_t index) const
+    {
+        return *mCollisionMasks[index];
     }
 
     size_t Size() const
     {
-        return mSequence->size();
+        return mSequence.size();
     }
 
     const std::string& GetSequenceId() const
@@ -35,7 +52,8 @@ public:
 
 private:
     std::string mSequenceId;
-    std::unique_ptr<std::vector<sf::Texture*>> mSequence;
+    std::vector<AtlasRegion> mSequence;
+    std::vector<const CollisionMask*> mCollisionMasks;
 };
 
 //------------------------------------------------------------------------------
@@ -51,32 +69,52 @@ public:
     {
         bool isFinished = false;
 
+        // Wrap rather than restart so a long catch-up timeslice lands on the frame it would have reached
         mFrameIndex += mFramesPerSecond * timeslice.asSeconds();
         if (mFrameIndex >= mCurrentSequence->Size())
         {
-            mFrameIndex = 0;
+            mFrameIndex = std::fmod(mFrameIndex, static_cast<float>(mCurrentSequence->Size()));
             isFinished = true;
         }
 
         return isFinished;
     }
 
-    void AddSequence(AnimationSequence&& sequence)
+    // Sequences are addressed by the index returned here, ids are only for resolving indices at load time
+    uint32_t AddSequence(AnimationSequence&& sequence)
     {
-        mSequenceMap.emplace(sequence.GetSequenceId(), std::move(sequence));
+        mSequences.push_back(std::move(sequence));
+        if (mCurrentSequence)
+        {
+            mCurrentSequence = &mSequences[mCurrentSequenceIndex];
+        }
+        return static_cast<uint32_t>(mSequences.size() - 1);
+    }
+
+    std::optional<uint32_t> FindSequence(const std::string& sequenceId) const
+    {
+        for (uint32_t index = 0; index < mSequences.size(); index++)
+        {
+            if (mSequences[index].GetSequenceId() == sequenceId)
+            {
+                return index;
+            }
+        }
+        return std::nullopt;
     }
 
-    void SetSequence(const std::string& sequenceId)
+    void SetSequence(uint32_t sequenceIndex)
     {
-        if (!mCurrentSequence || mCurrentSequence->GetSequenceId() != sequenceId)
+        if (sequenceIndex != mCurrentSequenceIndex)
         {
             mFrameIndex = 0;
-            mCurrentSequence = &mSequenceMap.at(sequenceId);
+            mCurrentSequenceIndex = sequenceIndex;
+            mCurrentSequence = &mSequences[sequenceIndex];
         }
     }
 
-    std::string GetCurrentSequenceId() 
-    { 
+    const std::string& GetCurrentSequenceId() const
+    {
         return mCurrentSequence->GetSequenceId(); 
     }
 
@@ -85,9 +123,14 @@ public:
         return static_cast<uint32_t>(mFrameIndex);
     }
 
-    const sf::Texture& GetTexture() const
+    const AtlasRegion& GetRegion() const
+    {
+        return mCurrentSequence->GetRegion(static_cast<uint32_t>(mFrameIndex));
+    }
+
+    const CollisionMask& GetCollisionMask() const
     {
-        return mCurrentSequence->GetTexture(static_cast<uint32_t>(mFrameIndex));
+        return mCurrentSequence->GetCollisionMask(static_cast<uint32_t>(mFrameIndex));
     }
 
     void Reset()
@@ -96,8 +139,9 @@ public:
     }
 
 private:
-    std::unordered_map<std::string, AnimationSequence> mSequenceMap;
+    std::vector<AnimationSequence> mSequences;
     AnimationSequence* mCurrentSequence = nullptr;
+    uint32_t mCurrentSequenceIndex = UINT32_MAX;
     float mFrameIndex;
     float mFramesPerSecond;
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "CollisionMask.h"
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+struct CollisionMaskKey
+{
+    const sf::Texture* mTexture;
+    sf::IntRect mTextureRect;
+
+    bool operator==(const CollisionMaskKey& other) const
+    {
+        return mTexture == other.mTexture && mTextureRect == other.mTextureRect;
+    }
+};
+
+//------------------------------------------------------------------------------
+struct CollisionMaskKeyHash
+{
+    size_t operator()(const CollisionMaskKey& key) const
+    {
+        size_t hash = std::hash<const sf::Texture*>()(key.mTexture);
+        for (int32_t value : { key.mTextureRect.left, key.mTextureRect.top, key.mTextureRect.width, key.mTextureRect.height })
+        {
+            hash ^= std::hash<int32_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+//------------------------------------------------------------------------------
+CollisionMask::CollisionMask(const sf::Image& image, const sf::IntRect& region)
+    : mSize(sf::Vector2u(region.getSize()))
+    , mWordsPerRow((mSize.x + BITS_PER_WORD - 1) / BITS_PER_WORD + 1)
+    , mBits(static_cast<size_t>(mWordsPerRow) * mSize.y, 0)
+    , mMirroredBits(static_cast<size_t>(mWordsPerRow) * mSize.y, 0)
+{
+    // Opaque column span of each row, left > right marks an empty row
+    std::vector<int32_t> rowLeft(mSize.y, static_cast<int32_t>(mSize.x));
+    std::vector<int32_t> rowRight(mSize.y, -1);
+
+    for (uint32_t y = 0; y < mSize.y; y++)
+    {
+        for (uint32_t x = 0; x < mSize.x; x++)
+        {
+            sf::Vector2u pixelPosition(region.left + x, region.top + y);
+            if (image.getPixel(pixelPosition).a != 0)
+            {
+                SetBit(mBits, x, y);
+                SetBit(mMirroredBits, mSize.x - 1 - x, y);
+                rowLeft[y] = std::min(rowLeft[y], static_cast<int32_t>(x));
+                rowRight[y] = std::max(rowRight[y], static_cast<int32_t>(x));
+            }
+        }
+    }
+
+    ComputeOpaqueBounds(rowLeft, rowRight);
+}
+
+//------------------------------------------------------------------------------
+void CollisionMask::SetBit(std::vector<uint64_t>& bits, uint32_t x, uint32_t y)
+{
+    bits[static_cast<size_t>(y) * mWordsPerRow + x / BITS_PER_WORD] |= uint64_t(1) << (x % BITS_PER_WORD);
+}
+
+//------------------------------------------------------------------------------
+void CollisionMask::ComputeOpaqueBounds(const std::vector<int32_t>& rowLeft, const std::vector<int32_t>& rowRight)
+{
+    auto computeBounds = [&](uint32_t startY, uint32_t endY) -> sf::IntRect
+    {
+        int32_t left = static_cast<int32_t>(mSize.x);
+        int32_t right = -1;
+        int32_t top = -1;
+        int32_t bottom = -1;
+        for (uint32_t y = startY; y < endY; y++)
+        {
+            if (rowLeft[y] <= rowRight[y])
+            {
+                left = std::min(left, rowLeft[y]);
+                right = std::max(right, rowRight[y]);
+                top = top < 0 ? static_cast<int32_t>(y) : top;
+                bottom = static_cast<int32_t>(y);
+            }
+        }
+
+        if (top < 0)
+        {
+            return sf::IntRect();
+        }
+        return sf::IntRect({ left, top }, { right - left + 1, bottom - top + 1 });
+    };
+
+    mOpaqueBounds = computeBounds(0, mSize.y);
+
+    uint32_t bandHeight = (mSize.y + OPAQUE_SUB_BOUNDS_COUNT - 1) / OPAQUE_SUB_BOUNDS_COUNT;
+    for (uint32_t startY = 0; bandHeight > 0 && startY < mSize.y; startY += bandHeight)
+    {
+        sf::IntRect bandBounds = computeBounds(startY, std::min(startY + bandHeight, mSize.y));
+        if (bandBounds.width > 0)
+        {
+            mOpaqueSubBounds.push_back(bandBounds);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+static std::unordered_map<CollisionMaskKey, CollisionMask, CollisionMaskKeyHash> sCollisionMaskStore;
+
+//------------------------------------------------------------------------------
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture, const sf::IntRect& textureRect)
+{
+    CollisionMaskKey key{ &texture, textureRect };
+    auto it = sCollisionMaskStore.find(key);
+    if (it != sCollisionMaskStore.end())
+    {
+        return it->second;
+    }
+
+    // One GPU readback per (texture, textureRect) - all further tests run against the packed mask
+    sf::Image image = texture.copyToImage();
+
+    auto inserted = sCollisionMaskStore.emplace(key, CollisionMask(image, textureRect));
+    return inserted.first->second;
+}
+
+//------------------------------------------------------------------------------
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Image& image)
+{
+    CollisionMaskKey key{ &texture, textureRect };
+    auto it = sCollisionMaskStore.find(key);
+    if (it != sCollisionMaskStore.end())
+    {
+        return it->second;
+    }
+
+    auto inserted = sCollisionMaskStore.emplace(key, CollisionMask(image, textureRect));
+    return inserted.first->second;
+}
+
+//------------------------------------------------------------------------------
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture)
+{
+    return LoadCollisionMask(texture, sf::IntRect({ 0, 0 }, sf::Vector2i(texture.getSize())));
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// System
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+class CollisionMask
+{
+public:
+    static constexpr uint32_t BITS_PER_WORD = 64;
+    static constexpr uint32_t OPAQUE_SUB_BOUNDS_COUNT = 3;
+
+    CollisionMask(const sf::Image& image, const sf::IntRect& region);
+
+    bool TestBit(const sf::Vector2i& position) const
+    {
+        if (position.x < 0 || position.y < 0 ||
+            position.x >= static_cast<int32_t>(mSize.x) || position.y >= static_cast<int32_t>(mSize.y))
+        {
+            return false;
+        }
+
+        const uint64_t* row = GetRow(static_cast<uint32_t>(position.y), false);
+        return (row[position.x / BITS_PER_WORD] >> (position.x % BITS_PER_WORD)) & 1u;
+    }
+
+    // Rows are padded with one trailing zero word so shifted reads never need a bounds check
+    const uint64_t* GetRow(uint32_t y, bool isMirrored) const
+    {
+        const std::vector<uint64_t>& bits = isMirrored ? mMirroredBits : mBits;
+        return bits.data() + static_cast<size_t>(y) * mWordsPerRow;
+    }
+
+    uint32_t GetWordsPerRow() const
+    {
+        return mWordsPerRow;
+    }
+
+    const sf::Vector2u& GetSize() const
+    {
+        return mSize;
+    }
+
+    // Tight box around the opaque pixels - empty for fully transparent masks
+    const sf::IntRect& GetOpaqueBounds() const
+    {
+        return mOpaqueBounds;
+    }
+
+    // Opaque bounds of up to OPAQUE_SUB_BOUNDS_COUNT horizontal bands, top to bottom
+    const std::vector<sf::IntRect>& GetOpaqueSubBounds() const
+    {
+        return mOpaqueSubBounds;
+    }
+
+private:
+    void SetBit(std::vector<uint64_t>& bits, uint32_t x, uint32_t y);
+    void ComputeOpaqueBounds(const std::vector<int32_t>& rowLeft, const std::vector<int32_t>& rowRight);
+
+    sf::Vector2u mSize;
+    uint32_t mWordsPerRow;
+    std::vector<uint64_t> mBits;
+    std::vector<uint64_t> mMirroredBits;
+    sf::IntRect mOpaqueBounds;
+    std::vector<sf::IntRect> mOpaqueSubBounds;
+};
+
+//------------------------------------------------------------------------------
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture, const sf::IntRect& textureRect);
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture);
+
+// For callers that already hold the texture's pixels, skips the GPU readback
+const CollisionMask& LoadCollisionMask(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Image& image);
\ No newline at end of file
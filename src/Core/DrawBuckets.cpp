@@ -0,0 +1,255 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "DrawBuckets.h"
+
+// Core
+#include "RenderQueue.h"
+#include "JobSystem.h"
+
+// System
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+static uint64_t GetCellKey(int32_t cellX, int32_t cellY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+//------------------------------------------------------------------------------
+DrawBuckets::DrawBuckets(float cellSize)
+    : mCellSize(cellSize)
+    , mNextSequence(0)
+    , mQueryStamp(0)
+{
+    mObjects.SetListener(this);
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::AddGameObject(GameObject* object)
+{
+    mObjects.AddGameObject(object);
+    if (object->IsMarkedForRemoval())
+    {
+        return;
+    }
+
+    uint32_t slotIndex = object->GetEntityHandle().mIndex;
+    if (slotIndex >= mProxies.size())
+    {
+        mProxies.resize(slotIndex + 1);
+    }
+
+    Proxy& proxy = mProxies[slotIndex];
+    if (proxy.mObject == object)
+    {
+        return;
+    }
+
+    uint32_t depth = object->GetDepth();
+    if (mBuckets.size() <= depth)
+    {
+        mBuckets.resize(depth + 1);
+    }
+
+    proxy = Proxy();
+    proxy.mObject = object;
+    proxy.mBounds = object->GetGlobalBounds();
+    proxy.mCellRange = GetCellRange(proxy.mBounds);
+    proxy.mSequence = mNextSequence++;
+    proxy.mDepth = depth;
+    proxy.mQueryStamp = mQueryStamp;
+    BinProxy(slotIndex);
+
+    // Reading the bounds above cleared the dirty flag, so the next move is reported
+    object->SetWorldBoundsListener(this);
+}
+
+//------------------------------------------------------------------------------
+// Members are about to be destroyed wholesale, so they are forgotten without being touched
+void DrawBuckets::Clear()
+{
+    mObjects.Clear();
+
+    // Cell vectors stay allocated, the next scene is built over the same level
+    for (Bucket& bucket : mBuckets)
+    {
+        for (auto& [cellKey, cell] : bucket.mCells)
+        {
+            cell.clear();
+        }
+    }
+    mProxies.clear();
+    mMovedSlots.clear();
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::Submit(RenderQueue& renderQueue, const sf::FloatRect& visibleRegion)
+{
+    for (uint32_t slotIndex : mMovedSlots)
+    {
+        Rebin(slotIndex);
+    }
+    mMovedSlots.clear();
+
+    FloatRect queryRegion(visibleRegion);
+    sf::IntRect cellRange = GetCellRange(queryRegion);
+    for (const Bucket& bucket : mBuckets)
+    {
+        SubmitBucket(bucket, renderQueue, cellRange, queryRegion);
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::OnGameObjectRemoved(GameObject& object)
+{
+    uint32_t slotIndex = object.GetEntityHandle().mIndex;
+    if (slotIndex < mProxies.size() && mProxies[slotIndex].mObject == &object)
+    {
+        UnbinProxy(slotIndex);
+        mProxies[slotIndex].mObject = nullptr;
+        object.SetWorldBoundsListener(nullptr);
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::OnWorldBoundsDirty(GameObject& object)
+{
+    uint32_t slotIndex = object.GetEntityHandle().mIndex;
+
+    // Proxies are only written on the main thread, so a job reading the flag is safe. Two jobs may
+    // still both see it clear, QueueMove drops the second one
+    if (mProxies[slotIndex].mIsMoveQueued)
+    {
+        return;
+    }
+
+    if (JobSystem::IsInParallelFor())
+    {
+        JobSystem::Defer([this, slotIndex]() { QueueMove(slotIndex); });
+        return;
+    }
+    QueueMove(slotIndex);
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::QueueMove(uint32_t slotIndex)
+{
+    Proxy& proxy = mProxies[slotIndex];
+    if (proxy.mObject && !proxy.mIsMoveQueued)
+    {
+        proxy.mIsMoveQueued = true;
+        mMovedSlots.push_back(slotIndex);
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::Rebin(uint32_t slotIndex)
+{
+    Proxy& proxy = mProxies[slotIndex];
+    proxy.mIsMoveQueued = false;
+
+    // Killed after it moved
+    if (!proxy.mObject)
+    {
+        return;
+    }
+
+    proxy.mBounds = proxy.mObject->GetGlobalBounds();
+    sf::IntRect cellRange = GetCellRange(proxy.mBounds);
+    if (cellRange != proxy.mCellRange)
+    {
+        UnbinProxy(slotIndex);
+        proxy.mCellRange = cellRange;
+        BinProxy(slotIndex);
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::BinProxy(uint32_t slotIndex)
+{
+    const Proxy& proxy = mProxies[slotIndex];
+    Bucket& bucket = mBuckets[proxy.mDepth];
+    const sf::IntRect& cellRange = proxy.mCellRange;
+    for (int32_t cellY = cellRange.top; cellY < cellRange.top + cellRange.height; cellY++)
+    {
+        for (int32_t cellX = cellRange.left; cellX < cellRange.left + cellRange.width; cellX++)
+        {
+            bucket.mCells[GetCellKey(cellX, cellY)].push_back(slotIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::UnbinProxy(uint32_t slotIndex)
+{
+    const Proxy& proxy = mProxies[slotIndex];
+    Bucket& bucket = mBuckets[proxy.mDepth];
+    const sf::IntRect& cellRange = proxy.mCellRange;
+    for (int32_t cellY = cellRange.top; cellY < cellRange.top + cellRange.height; cellY++)
+    {
+        for (int32_t cellX = cellRange.left; cellX < cellRange.left + cellRange.width; cellX++)
+        {
+            // Order inside a cell does not matter, visible objects are sorted by sequence
+            std::vector<uint32_t>& cell = bucket.mCells[GetCellKey(cellX, cellY)];
+            auto it = std::find(cell.begin(), cell.end(), slotIndex);
+            if (it != cell.end())
+            {
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void DrawBuckets::SubmitBucket(const Bucket& bucket, RenderQueue& renderQueue, const sf::IntRect& cellRange, const FloatRect& visibleRegion)
+{
+    ++mQueryStamp;
+    mVisibleSlots.clear();
+
+    for (int32_t cellY = cellRange.top; cellY < cellRange.top + cellRange.height; cellY++)
+    {
+        for (int32_t cellX = cellRange.left; cellX < cellRange.left + cellRange.width; cellX++)
+        {
+            auto it = bucket.mCells.find(GetCellKey(cellX, cellY));
+            if (it == bucket.mCells.end())
+            {
+                continue;
+            }
+
+            for (uint32_t slotIndex : it->second)
+            {
+                Proxy& proxy = mProxies[slotIndex];
+                if (proxy.mQueryStamp != mQueryStamp)
+                {
+                    proxy.mQueryStamp = mQueryStamp;
+                    if (proxy.mBounds.FindIntersection(visibleRegion))
+                    {
+                        mVisibleSlots.push_back(slotIndex);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(mVisibleSlots.begin(), mVisibleSlots.end(), [this](uint32_t slotIndex0, uint32_t slotIndex1) {
+        return mProxies[slotIndex0].mSequence < mProxies[slotIndex1].mSequence;
+    });
+
+    for (uint32_t slotIndex : mVisibleSlots)
+    {
+        mProxies[slotIndex].mObject->SubmitDraw(renderQueue);
+    }
+}
+
+//------------------------------------------------------------------------------
+sf::IntRect DrawBuckets::GetCellRange(const FloatRect& bounds) const
+{
+    int32_t startX = static_cast<int32_t>(std::floor(bounds.GetLeft() / mCellSize));
+    int32_t startY = static_cast<int32_t>(std::floor(bounds.GetTop() / mCellSize));
+    int32_t endX = static_cast<int32_t>(std::floor(bounds.GetRight() / mCellSize)) + 1;
+    int32_t endY = static_cast<int32_t>(std::floor(bounds.GetBottom() / mCellSize)) + 1;
+
+    return sf::IntRect({ startX, startY }, { endX - startX, endY - startY });
+}
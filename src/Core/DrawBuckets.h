@@ -0,0 +1,82 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// Core
+#include "Group.h"
+#include "GameObject.h"
+#include "FloatRect.h"
+
+// System
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Forward declarations
+//------------------------------------------------------------------------------
+class RenderQueue;
+
+//------------------------------------------------------------------------------
+// Drawn objects bucketed by depth, each bucket a uniform grid over the objects' world bounds so only
+// cells overlapping the view are visited. The grid is kept up to date incrementally: objects are binned
+// when added, unbinned when they leave the group (kills included), and re-binned only after their
+// cached world bounds went stale and then landed in different cells. Nothing is rebuilt per frame.
+//
+// Every object gets a sequence number when added and each bucket submits its visible objects in that
+// order, so draw order inside a depth never depends on grid or removal history
+class DrawBuckets : private IGroupListener, private IWorldBoundsListener
+{
+public:
+    explicit DrawBuckets(float cellSize = 256.0f);
+
+    // Members point back here, so the buckets stay put
+    DrawBuckets(const DrawBuckets&) = delete;
+    DrawBuckets& operator=(const DrawBuckets&) = delete;
+
+    // The bucket is picked from GetDepth() once, depths are fixed for an object's lifetime
+    void AddGameObject(GameObject* object);
+    void Clear();
+
+    // Re-bins the objects that moved since the last call, then submits the visible objects of every
+    // bucket in depth order and in insertion order per bucket
+    void Submit(RenderQueue& renderQueue, const sf::FloatRect& visibleRegion);
+
+private:
+    // Indexed by entity slot, an object is in exactly one bucket
+    struct Proxy
+    {
+        GameObject* mObject = nullptr;      // Null while the slot is not drawn
+        FloatRect mBounds;
+        sf::IntRect mCellRange;             // Cells the object is currently binned in
+        uint64_t mSequence = 0;
+        uint32_t mDepth = 0;
+        uint32_t mQueryStamp = 0;
+        bool mIsMoveQueued = false;
+    };
+
+    struct Bucket
+    {
+        std::unordered_map<uint64_t, std::vector<uint32_t>> mCells;    // Cell key to entity slots
+    };
+
+    void OnGameObjectRemoved(GameObject& object) override;
+    void OnWorldBoundsDirty(GameObject& object) override;
+    void QueueMove(uint32_t slotIndex);
+    void Rebin(uint32_t slotIndex);
+    void BinProxy(uint32_t slotIndex);
+    void UnbinProxy(uint32_t slotIndex);
+    void SubmitBucket(const Bucket& bucket, RenderQueue& renderQueue, const sf::IntRect& cellRange, const FloatRect& visibleRegion);
+    sf::IntRect GetCellRange(const FloatRect& bounds) const;
+
+    float mCellSize;
+    Group mObjects;                         // Membership only, reports removals back here
+    std::vector<Bucket> mBuckets;
+    std::vector<Proxy> mProxies;
+    std::vector<uint32_t> mMovedSlots;
+    std::vector<uint32_t> mVisibleSlots;
+    uint64_t mNextSequence;
+    uint32_t mQueryStamp;
+};
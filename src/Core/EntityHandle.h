@@ -0,0 +1,29 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Index into the GameObjectManager slot map plus the generation the slot had when the object was
+// created, slots bump their generation on release so handles to dead objects stop resolving
+struct EntityHandle
+{
+    static constexpr uint32_t INVALID_GENERATION = 0;
+
+    uint32_t mIndex = 0;
+    uint32_t mGeneration = INVALID_GENERATION;
+
+    bool IsValid() const { return mGeneration != INVALID_GENERATION; }
+
+    bool operator==(const EntityHandle& other) const
+    {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+    }
+
+    bool operator!=(const EntityHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
@@ -1,22 +1,65 @@
 #include "EventQueue.h"
 #include "GameObject.h"
 
+// System
+#include <algorithm>
+
 // Static definitions
 //------------------------------------------------------------------------------
 EventQueue* EventQueue::sInstance = nullptr;
 
 //------------------------------------------------------------------------------
-void EventQueue::QueueEvent(std::unique_ptr<Event> event)
+EventQueue::EventQueue()
 {
-    mQueue.push_back(std::move(event));
+    mQueue.reserve(INITIAL_QUEUE_CAPACITY);
 }
 
 //------------------------------------------------------------------------------
-void EventQueue::DispatchEvents(GameObject* object)
+void EventQueue::PushEvent(const Event& event)
 {
-    for (auto& event : mQueue) 
+    if (mQueue.size() == mQueue.capacity())
     {
-        object->HandleEvent(event.get());
+        ++mAllocationCount;
+    }
+    mQueue.push_back(event);
+}
+
+//------------------------------------------------------------------------------
+void EventQueue::DispatchEvents()
+{
+    // Indexing throughout since handlers may queue events or create objects that subscribe. Listeners
+    // destroyed by a handler unsubscribe, which only blanks their entry until the dispatch is over
+    mIsDispatching = true;
+    for (size_t eventIndex = 0; eventIndex < mQueue.size(); eventIndex++)
+    {
+        // Copied out since queueing from a handler may move the storage
+        Event event = mQueue[eventIndex];
+        if (event.mEventType >= mSubscriptions.size())
+        {
+            continue;
+        }
+
+        const size_t subscriptionCount = mSubscriptions[event.mEventType].size();
+        for (size_t index = 0; index < subscriptionCount; index++)
+        {
+            const Subscription& subscription = mSubscriptions[event.mEventType][index];
+            if (subscription.mListener && (!subscription.mSender.IsValid() || event.IsFromSender(subscription.mSender)))
+            {
+                subscription.mListener->HandleEvent(&event);
+            }
+        }
+    }
+    mIsDispatching = false;
+
+    if (mHasBlankedSubscriptions)
+    {
+        for (std::vector<Subscription>& subscriptions : mSubscriptions)
+        {
+            subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(), [](const Subscription& subscription) {
+                return subscription.mListener == nullptr;
+            }), subscriptions.end());
+        }
+        mHasBlankedSubscriptions = false;
     }
 }
 
@@ -24,4 +67,51 @@ void EventQueue::DispatchEvents(GameObject* object)
 void EventQueue::Clear()
 {
     mQueue.clear();
+}
+
+//------------------------------------------------------------------------------
+void EventQueue::Subscribe(uint32_t eventType, GameObject* listener, EntityHandle sender)
+{
+    if (eventType >= mSubscriptions.size())
+    {
+        mSubscriptions.resize(eventType + 1);
+        ++mAllocationCount;
+    }
+
+    std::vector<Subscription>& subscriptions = mSubscriptions[eventType];
+    if (subscriptions.size() == subscriptions.capacity())
+    {
+        ++mAllocationCount;
+    }
+    subscriptions.push_back({ listener, sender });
+}
+
+//------------------------------------------------------------------------------
+void EventQueue::Unsubscribe(uint32_t eventType, GameObject* listener)
+{
+    if (eventType >= mSubscriptions.size())
+    {
+        return;
+    }
+
+    std::vector<Subscription>& subscriptions = mSubscriptions[eventType];
+    auto it = std::find_if(subscriptions.begin(), subscriptions.end(), [listener](const Subscription& subscription) {
+        return subscription.mListener == listener;
+    });
+    if (it == subscriptions.end())
+    {
+        return;
+    }
+
+    // Swap removal would move an entry the running dispatch has not reached yet
+    if (mIsDispatching)
+    {
+        it->mListener = nullptr;
+        mHasBlankedSubscriptions = true;
+    }
+    else
+    {
+        *it = subscriptions.back();
+        subscriptions.pop_back();
+    }
 }
\ No newline at end of file
@@ -6,19 +6,23 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <type_traits>
 #include <cassert>
 
+// Core
+#include "EntityHandle.h"
+
 // Forward Declarations
 //------------------------------------------------------------------------------
 class GameObject;
 
 //------------------------------------------------------------------------------
+// Plain record queued by value, derived events only name a type and must not add members
 struct Event 
 {
-    virtual ~Event() = default;
-    Event(uint32_t eventType, uint32_t senderId)
+    Event(uint32_t eventType, EntityHandle sender)
         : mEventType(eventType)
-        , mSenderId(senderId)
+        , mSender(sender)
     { }
 
     template<typename EventType>
@@ -27,20 +31,23 @@ struct Event
         return mEventType == static_cast<uint32_t>(type);
     }
 
-    bool IsFromSender(uint32_t senderId) const 
+    bool IsFromSender(EntityHandle sender) const 
     {
-        return mSenderId == senderId;
+        return mSender == sender;
     }
 
 private:
+    friend class EventQueue;
+
     uint32_t mEventType;
-    uint32_t mSenderId;
+    EntityHandle mSender;
 };
 
 //------------------------------------------------------------------------------
 class EventQueue
 {
     static EventQueue* sInstance;
+    static constexpr uint32_t INITIAL_QUEUE_CAPACITY = 128;
 
 public:
     EventQueue(const EventQueue&) = delete;
@@ -61,12 +68,48 @@ public:
         return sInstance;
     }
 
-    void QueueEvent(std::unique_ptr<Event> event);
-    void DispatchEvents(GameObject* object);
+    // Listeners only receive events of the subscribed type, and only from sender when it is valid
+    template<typename EventType>
+    void Subscribe(EventType type, GameObject* listener, EntityHandle sender = { })
+    {
+        Subscribe(static_cast<uint32_t>(type), listener, sender);
+    }
+
+    template<typename EventType>
+    void Unsubscribe(EventType type, GameObject* listener)
+    {
+        Unsubscribe(static_cast<uint32_t>(type), listener);
+    }
+
+    template<typename T>
+    void QueueEvent(const T& event)
+    {
+        static_assert(std::is_base_of_v<Event, T> && sizeof(T) == sizeof(Event), "Events are fixed size records");
+        static_assert(std::is_trivially_copyable_v<T>, "Events are copied into reused storage");
+        PushEvent(static_cast<const Event&>(event));
+    }
+
+    void DispatchEvents();
     void Clear();
 
+    // Number of times event or subscription storage had to grow, flat once gameplay reaches steady state
+    uint64_t GetAllocationCount() const { return mAllocationCount; }
+
 private:
-    EventQueue() = default;
+    struct Subscription
+    {
+        GameObject* mListener;
+        EntityHandle mSender;
+    };
+
+    EventQueue();
+    void PushEvent(const Event& event);
+    void Subscribe(uint32_t eventType, GameObject* listener, EntityHandle sender);
+    void Unsubscribe(uint32_t eventType, GameObject* listener);
     
-    std::vector<std::unique_ptr<Event>> mQueue;
+    std::vector<Event> mQueue;                                 // Cleared each sync, keeping its capacity
+    std::vector<std::vector<Subscription>> mSubscriptions;     // Indexed by event type
+    uint64_t mAllocationCount = 0;
+    bool mIsDispatching = false;
+    bool mHasBlankedSubscriptions = false;
 };
@@ -15,7 +15,7 @@ enum class EntityCoreEventType : uint32_t
 //------------------------------------------------------------------------------
 struct EntityRemovedFromSceneEvent : public Event 
 {
-    EntityRemovedFromSceneEvent(uint32_t senderId)
-        : Event(static_cast<uint32_t>(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE), senderId)
+    EntityRemovedFromSceneEvent(EntityHandle sender)
+        : Event(static_cast<uint32_t>(EntityCoreEventType::ENTITY_REMOVE_FROM_SCENE), sender)
     { }
 };
\ No newline at end of file
@@ -0,0 +1,16 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "FrameArena.h"
+
+//------------------------------------------------------------------------------
+LinearArena& GetFrameArena()
+{
+    static LinearArena arena(16 * 1024);
+    return arena;
+}
+
+//------------------------------------------------------------------------------
+void ResetFrameArena()
+{
+    GetFrameArena().Reset();
+}
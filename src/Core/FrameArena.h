@@ -0,0 +1,13 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Core
+#include "LinearArena.h"
+
+//------------------------------------------------------------------------------
+// Scratch memory for temporaries that never outlive the current simulation tick, meant for
+// std::pmr containers on the update path. The main loop rewinds it at the start of every tick.
+// Main thread only, parallel updates must not draw from it
+LinearArena& GetFrameArena();
+void ResetFrameArena();
@@ -7,10 +7,18 @@
 
 // Core
 #include "Group.h"
+#include "JobSystem.h"
 
 //------------------------------------------------------------------------------
 void GameObject::Kill()
 {
+    // Group membership is shared state, so parallel updates leave the kill to the main thread
+    if (JobSystem::IsInParallelFor())
+    {
+        JobSystem::Defer([this]() { Kill(); });
+        return;
+    }
+
     mIsMarkedForRemoval = true;
     for (auto group : mTrackedGroups)
     {
@@ -22,7 +30,7 @@ void GameObject::Kill()
 //------------------------------------------------------------------------------
 void GameObject::TrackGroupMembership(Group* group)
 {
-    mTrackedGroups.insert(group);
+    mTrackedGroups.push_back(group);
 }
 
 //------------------------------------------------------------------------------
@@ -30,50 +38,59 @@ void GameObject::UntrackGroupMembership(Group* group)
 {
     if (!mIsMarkedForRemoval)
     {
-        mTrackedGroups.erase(group);
+        auto it = std::find(mTrackedGroups.begin(), mTrackedGroups.end(), group);
+        if (it != mTrackedGroups.end())
+        {
+            *it = mTrackedGroups.back();
+            mTrackedGroups.pop_back();
+        }
     }
 }
 
 //------------------------------------------------------------------------------
 bool GameObject::IsDownCollision(const GameObject& other) const
 {
-    FloatRect hitbox0 = GetHitbox();
-    FloatRect previousHitbox0 = GetPreviousHitbox();
-    FloatRect hitbox1 = other.GetHitbox();
-    FloatRect previousHitbox1 = other.GetPreviousHitbox();
+    return IsDownCollision(GetHitbox(), GetPreviousHitbox(), other.GetHitbox(), other.GetPreviousHitbox());
+}
 
+//------------------------------------------------------------------------------
+/*static*/ bool GameObject::IsDownCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1)
+{
     return hitbox0.GetBottom() >= hitbox1.GetTop() && previousHitbox0.GetBottom() <= previousHitbox1.GetTop();
 }
 
 //------------------------------------------------------------------------------
 bool GameObject::IsUpCollision(const GameObject& other) const
 {
-    FloatRect hitbox0 = GetHitbox();
-    FloatRect previousHitbox0 = GetPreviousHitbox();
-    FloatRect hitbox1 = other.GetHitbox();
-    FloatRect previousHitbox1 = other.GetPreviousHitbox();
+    return IsUpCollision(GetHitbox(), GetPreviousHitbox(), other.GetHitbox(), other.GetPreviousHitbox());
+}
 
+//------------------------------------------------------------------------------
+/*static*/ bool GameObject::IsUpCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1)
+{
     return hitbox0.GetTop() <= hitbox1.GetBottom() && previousHitbox0.GetTop() >= previousHitbox1.GetBottom();
 }
 
 //------------------------------------------------------------------------------
 bool GameObject::IsLeftCollision(const GameObject& other) const
 {
-    FloatRect hitbox0 = GetHitbox();
-    FloatRect previousHitbox0 = GetPreviousHitbox();
-    FloatRect hitbox1 = other.GetHitbox();
-    FloatRect previousHitbox1 = other.GetPreviousHitbox();
+    return IsLeftCollision(GetHitbox(), GetPreviousHitbox(), other.GetHitbox(), other.GetPreviousHitbox());
+}
 
+//------------------------------------------------------------------------------
+/*static*/ bool GameObject::IsLeftCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1)
+{
     return hitbox0.GetLeft() <= hitbox1.GetRight() && previousHitbox0.GetLeft() >= previousHitbox1.GetRight();
 }
 
 //------------------------------------------------------------------------------
 bool GameObject::IsRightCollision(const GameObject& other) const
 {
-    FloatRect hitbox0 = GetHitbox();
-    FloatRect previousHitbox0 = GetPreviousHitbox();
-    FloatRect hitbox1 = other.GetHitbox();
-    FloatRect previousHitbox1 = other.GetPreviousHitbox();
+    return IsRightCollision(GetHitbox(), GetPreviousHitbox(), other.GetHitbox(), other.GetPreviousHitbox());
+}
 
+//------------------------------------------------------------------------------
+/*static*/ bool GameObject::IsRightCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1)
+{
     return hitbox0.GetRight() >= hitbox1.GetLeft() && previousHitbox0.GetRight() <= previousHitbox1.GetLeft();
 }
\ No newline at end of file
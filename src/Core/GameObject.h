@@ -12,6 +12,19 @@
 #include "Transformable.h"
 #include "FloatRect.h"
 #include "EventQueue.h"
+#include "EntityHandle.h"
+
+// Forward declarations
+//------------------------------------------------------------------------------
+class RenderQueue;
+class GameObject;
+
+//------------------------------------------------------------------------------
+class IWorldBoundsListener
+{
+public:
+    virtual void OnWorldBoundsDirty(GameObject& object) = 0;
+};
 
 //------------------------------------------------------------------------------
 class GameObject : public sf::Drawable, public Tranformable
@@ -19,20 +32,28 @@ class GameObject : public sf::Drawable, public Tranformable
 public:
     virtual ~GameObject() = default;
 
-    virtual FloatRect GetGlobalBounds() const = 0;
+    FloatRect GetGlobalBounds() const { return GetWorldBounds(); }
     virtual uint32_t GetDepth() const { return 0; }
     virtual void Update(const sf::Time& timeslice) { };
     virtual void draw(sf::RenderTarget& target, const sf::RenderStates& states) const { }
+    virtual void SubmitDraw(RenderQueue& renderQueue) const { }     // Batched alternative to draw
 
     // Collision detection
     virtual FloatRect GetHitbox() const { return GetGlobalBounds(); }
     virtual FloatRect GetPreviousHitbox() const { return GetHitbox(); }    
+    virtual FloatRect GetHurtbox() const { return GetHitbox(); }
     virtual const sf::Vector2f GetVelocity() const { return { }; };    
     bool IsDownCollision(const GameObject& other) const;    
     bool IsUpCollision(const GameObject& other) const;
     bool IsLeftCollision(const GameObject& other) const;        
     bool IsRightCollision(const GameObject& other) const;
 
+    // Same checks on already fetched hitboxes, for hot loops reading published bounds
+    static bool IsDownCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1);
+    static bool IsUpCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1);
+    static bool IsLeftCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1);
+    static bool IsRightCollision(const FloatRect& hitbox0, const FloatRect& previousHitbox0, const FloatRect& hitbox1, const FloatRect& previousHitbox1);
+
     // Group Membership
     void Kill();
     void TrackGroupMembership(Group* group);
@@ -40,12 +61,25 @@ public:
     bool IsMarkedForRemoval() const { return mIsMarkedForRemoval; }
     
     // Event Handling
-    void SetEntityId(uint32_t entityId) { mEntityId = entityId; }
-    uint32_t GetEntityId() const { return mEntityId; }
+    void SetEntityHandle(EntityHandle entityHandle) { mEntityHandle = entityHandle; }
+    EntityHandle GetEntityHandle() const { return mEntityHandle; }
     virtual void HandleEvent(Event* event) { };
 
+    // Spatial indices that keep the object binned by its world bounds, one at a time
+    void SetWorldBoundsListener(IWorldBoundsListener* listener) { mWorldBoundsListener = listener; }
+
+protected:
+    virtual void OnWorldBoundsDirty() override
+    {
+        if (mWorldBoundsListener)
+        {
+            mWorldBoundsListener->OnWorldBoundsDirty(*this);
+        }
+    }
+
 private:    
-    std::unordered_set<Group*> mTrackedGroups;
+    std::vector<Group*> mTrackedGroups;     // Objects join a handful of groups, so a flat list beats hashing
     bool mIsMarkedForRemoval = false;
-    uint32_t mEntityId = 0;
+    EntityHandle mEntityHandle;
+    IWorldBoundsListener* mWorldBoundsListener = nullptr;
 };
\ No newline at end of file
@@ -21,43 +21,107 @@ GameObjectManager::GameObjectManager()
 //------------------------------------------------------------------------------
 void GameObjectManager::SyncGameObjectChanges()
 {
-    for (auto it = mGameObjects.begin(); it != mGameObjects.end(); )
+    // Compact in place, then deliver removal events once the dead listeners have unsubscribed
+    size_t keptCount = 0;
+    for (size_t index = 0; index < mGameObjects.size(); index++)
     {
-        if ((*it)->IsMarkedForRemoval())
+        if (mGameObjects[index]->IsMarkedForRemoval())
         {
-            EventQueue::Instance()->QueueEvent(std::make_unique<EntityRemovedFromSceneEvent>((*it)->GetEntityId()));
-            mGameObjectLookup.erase((*it)->GetEntityId());
-            it = mGameObjects.erase(it);
+            EventQueue::Instance()->QueueEvent(EntityRemovedFromSceneEvent(mGameObjects[index]->GetEntityHandle()));
+            ReleaseSlot(mGameObjects[index]->GetEntityHandle());
+            mGameObjects[index].reset();
         }
         else
         {
-            EventQueue::Instance()->DispatchEvents(it->get());
-            ++it;
+            if (keptCount != index)
+            {
+                mGameObjects[keptCount] = std::move(mGameObjects[index]);
+            }
+            ++keptCount;
         }
     }
+    mGameObjects.erase(mGameObjects.begin() + keptCount, mGameObjects.end());
+    EventQueue::Instance()->DispatchEvents();
     EventQueue::Instance()->Clear();
 }
 
 //------------------------------------------------------------------------------
-GameObject* GameObjectManager::GetInstance(uint32_t entityId)
+GameObject* GameObjectManager::GetInstance(EntityHandle entityHandle) const
 {
-    auto it = mGameObjectLookup.find(entityId);
-    if (it != mGameObjectLookup.end())
+    if (entityHandle.mIndex < mSlots.size())
     {
-        return it->second;
+        const Slot& slot = mSlots[entityHandle.mIndex];
+        if (slot.mGeneration == entityHandle.mGeneration)
+        {
+            return slot.mObject;
+        }
     }
     return nullptr;
 }
 
 //------------------------------------------------------------------------------
-void GameObjectManager::RemoveAllGameObjects()
+// Tears the scene down without killing objects one by one, so no group bookkeeping or removal events.
+// Callers clear their own groups alongside. Every live handle is invalidated and the level arena
+// is rewound in one step
+void GameObjectManager::ClearScene()
 {
-    for (const std::unique_ptr<GameObject>& object : mGameObjects)
+    // Runs destructors only, pooled objects go back to their pools
+    mGameObjects.clear();
+    EventQueue::Instance()->Clear();
+
+    for (uint32_t index = 0; index < mSlots.size(); index++)
     {
-        if (!object->IsMarkedForRemoval())
+        if (mSlots[index].mObject)
         {
-            object->Kill();
+            ReleaseSlot({ index, mSlots[index].mGeneration });
         }
     }
-    SyncGameObjectChanges();
+
+    mLevelArena.Reset();
+}
+
+//------------------------------------------------------------------------------
+std::vector<PoolStats> GameObjectManager::GetPoolStats() const
+{
+    std::vector<PoolStats> poolStats;
+    for (const std::unique_ptr<IObjectPool>& pool : mObjectPools)
+    {
+        poolStats.push_back(pool->GetStats());
+    }
+    return poolStats;
+}
+
+//------------------------------------------------------------------------------
+EntityHandle GameObjectManager::AllocateSlot(GameObject* object)
+{
+    uint32_t index = 0;
+    if (mFreeSlots.empty())
+    {
+        index = static_cast<uint32_t>(mSlots.size());
+        mSlots.emplace_back();
+    }
+    else
+    {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+
+    Slot& slot = mSlots[index];
+    slot.mObject = object;
+    return { index, slot.mGeneration };
+}
+
+//------------------------------------------------------------------------------
+void GameObjectManager::ReleaseSlot(EntityHandle entityHandle)
+{
+    Slot& slot = mSlots[entityHandle.mIndex];
+    assert(slot.mGeneration == entityHandle.mGeneration);
+
+    // Bumping the generation invalidates every outstanding handle, skipping the invalid value on wrap
+    slot.mObject = nullptr;
+    if (++slot.mGeneration == EntityHandle::INVALID_GENERATION)
+    {
+        ++slot.mGeneration;
+    }
+    mFreeSlots.push_back(entityHandle.mIndex);
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 // Core
 #include "GameObject.h"
 #include "EventQueue.h"
+#include "ObjectPool.h"
+#include "LinearArena.h"
 
 //------------------------------------------------------------------------------
 class GameObjectManager
@@ -20,24 +22,65 @@ public:
     template<typename T, typename... Args>
     T* CreateGameObject(Args&&... args)
     {
-        auto gameObject = std::make_unique<T>(std::forward<Args>(args)...);
-        gameObject->SetEntityId(++mEntityIdCounter);
-        
-        T* ptr = gameObject.get();
-        mGameObjectLookup[mEntityIdCounter] = ptr;                     
-        mGameObjects.insert(std::move(gameObject));
+        T* ptr = nullptr;
+        GameObjectDeleter deleter = nullptr;
+        if constexpr (PoolTraits<T>::IS_POOLED)
+        {
+            ptr = GetObjectPool<T>().Create(std::forward<Args>(args)...);
+            deleter = [](GameObject* object) { Instance().GetObjectPool<T>().Release(static_cast<T*>(object)); };
+        }
+        else
+        {
+            // Memory is reclaimed all at once by ClearScene, so destruction only runs the destructor
+            ptr = new (mLevelArena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            deleter = [](GameObject* object) { static_cast<T*>(object)->~T(); };
+        }
+
+        ptr->SetEntityHandle(AllocateSlot(ptr));
+        mGameObjects.emplace_back(ptr, deleter);
 
         return ptr;
     }
 
     void SyncGameObjectChanges();
-    GameObject* GetInstance(uint32_t entityId);
-    void RemoveAllGameObjects();
+    GameObject* GetInstance(EntityHandle entityHandle) const;
+    void ClearScene();
+    std::vector<PoolStats> GetPoolStats() const;
 
 private:
+    using GameObjectDeleter = void(*)(GameObject*);
+
+    // Object stays null while the slot is on the free list
+    struct Slot
+    {
+        GameObject* mObject = nullptr;
+        uint32_t mGeneration = EntityHandle::INVALID_GENERATION + 1;
+    };
+
     GameObjectManager();
+    EntityHandle AllocateSlot(GameObject* object);
+    void ReleaseSlot(EntityHandle entityHandle);
+
+    // Pools are created on first use and owned here, so they outlive every object released into them
+    template<typename T>
+    ObjectPool<T>& GetObjectPool()
+    {
+        static ObjectPool<T>* pool = CreateObjectPool<T>();
+        return *pool;
+    }
+
+    template<typename T>
+    ObjectPool<T>* CreateObjectPool()
+    {
+        auto pool = std::make_unique<ObjectPool<T>>(PoolTraits<T>::NAME, PoolTraits<T>::CAPACITY);
+        ObjectPool<T>* ptr = pool.get();
+        mObjectPools.push_back(std::move(pool));
+        return ptr;
+    }
 
-    std::unordered_map<uint32_t, GameObject*> mGameObjectLookup;
-    std::unordered_set<std::unique_ptr<GameObject>> mGameObjects;    
-    uint32_t mEntityIdCounter = 0;
+    LinearArena mLevelArena;
+    std::vector<std::unique_ptr<IObjectPool>> mObjectPools;
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<std::unique_ptr<GameObject, GameObjectDeleter>> mGameObjects;
 };
\ No newline at end of file
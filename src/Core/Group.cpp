@@ -5,8 +5,9 @@
 #include "GameObjectManager.h"
 
 //------------------------------------------------------------------------------
-GroupIterator::GroupIterator(std::vector<GameObject*>::iterator it, Group* group)
-    : mCurrent(it)
+GroupIterator::GroupIterator(uint32_t index, uint32_t endIndex, Group* group)
+    : mIndex(index)
+    , mEndIndex(endIndex)
     , mGroup(group)
 {
     ++mGroup->mIterationCounter;
@@ -25,7 +26,7 @@ GroupIterator::~GroupIterator()
 //------------------------------------------------------------------------------
 GroupIterator& GroupIterator::operator++()
 {
-    ++mCurrent;
+    ++mIndex;
     SkipMarked();
     return *this;
 }
@@ -33,53 +34,144 @@ GroupIterator& GroupIterator::operator++()
 //------------------------------------------------------------------------------
 GameObject* GroupIterator::operator*()
 {
-    return *mCurrent;
+    return mGroup->mGameObjects[mIndex];
 }
 
 //------------------------------------------------------------------------------
 bool GroupIterator::operator!=(const GroupIterator& other)
 {
-    return mCurrent != other.mCurrent;
+    return mIndex != other.mIndex;
 }
 
 //------------------------------------------------------------------------------
 void GroupIterator::SkipMarked()
 {
-    while (mCurrent != mGroup->mSortedGameObjects.end() && mGroup->mRemoveQueue.find(*mCurrent) != mGroup->mRemoveQueue.end())
+    while (mIndex < mEndIndex && mGroup->mIsMarked[mIndex])
     {
-        ++mCurrent;
+        ++mIndex;
     }
 }
 
 //------------------------------------------------------------------------------
 void Group::AddGameObject(GameObject* obj)
 {
-    if (!obj->IsMarkedForRemoval() && mAddQueue.find(obj) == mAddQueue.end())
+    if (obj->IsMarkedForRemoval())
     {
-        obj->TrackGroupMembership(this);
+        return;
+    }
+
+    uint32_t denseIndex = GetDenseIndex(obj);
+    if (denseIndex != INVALID_INDEX)
+    {
+        // Re-added before a deferred removal was swept
+        if (mIsMarked[denseIndex])
+        {
+            obj->TrackGroupMembership(this);
+            mIsMarked[denseIndex] = false;
+        }
+        return;
+    }
+
+    obj->TrackGroupMembership(this);
 
-        mAddQueue.insert(obj);
-        mRemoveQueue.erase(obj);
-        ProcessQueues();
+    uint32_t slotIndex = obj->GetEntityHandle().mIndex;
+    if (slotIndex >= mSparse.size())
+    {
+        mSparse.resize(slotIndex + 1, INVALID_INDEX);
     }
+    mSparse[slotIndex] = static_cast<uint32_t>(mGameObjects.size());
+    mGameObjects.push_back(obj);
+    mIsMarked.push_back(false);
 }
 
 //------------------------------------------------------------------------------
 void Group::RemoveGameObject(GameObject* obj)
 {
-    if (mRemoveQueue.find(obj) == mRemoveQueue.end())
+    uint32_t denseIndex = GetDenseIndex(obj);
+    if (denseIndex == INVALID_INDEX || mIsMarked[denseIndex])
     {
+        return;
+    }
+
+    obj->UntrackGroupMembership(this);
 
-        obj->UntrackGroupMembership(this);
+    if (mIterationCounter == 0)
+    {
+        SwapRemove(denseIndex);
+    }
+    else
+    {
+        mIsMarked[denseIndex] = true;
+        mRemoveQueue.push_back(obj);
+    }
 
-        mRemoveQueue.insert(obj);
-        mAddQueue.erase(obj);
-        ProcessQueues();
+    if (mListener)
+    {
+        mListener->OnGameObjectRemoved(*obj);
     }
 }
 
 //------------------------------------------------------------------------------
 void Group::Sort(const std::function<bool(GameObject*, GameObject*)>& compareFunc)
 {
-    std::sort(mSortedGameObjects.begin(), mSortedGameObjects.end(), compareFunc);
-}
\ No newline at end of file
+    assert(mIterationCounter == 0);
+
+    std::sort(mGameObjects.begin(), mGameObjects.end(), compareFunc);
+    for (uint32_t denseIndex = 0; denseIndex < mGameObjects.size(); denseIndex++)
+    {
+        mSparse[mGameObjects[denseIndex]->GetEntityHandle().mIndex] = denseIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Forgets every member without untracking, for scene teardown where the members are destroyed next
+void Group::Clear()
+{
+    assert(mIterationCounter == 0);
+
+    mSparse.clear();
+    mGameObjects.clear();
+    mIsMarked.clear();
+    mRemoveQueue.clear();
+}
+
+//------------------------------------------------------------------------------
+uint32_t Group::GetDenseIndex(const GameObject* obj) const
+{
+    uint32_t slotIndex = obj->GetEntityHandle().mIndex;
+    if (slotIndex < mSparse.size())
+    {
+        return mSparse[slotIndex];
+    }
+    return INVALID_INDEX;
+}
+
+//------------------------------------------------------------------------------
+void Group::SwapRemove(uint32_t denseIndex)
+{
+    uint32_t lastIndex = static_cast<uint32_t>(mGameObjects.size()) - 1;
+    mSparse[mGameObjects[denseIndex]->GetEntityHandle().mIndex] = INVALID_INDEX;
+    if (denseIndex != lastIndex)
+    {
+        mGameObjects[denseIndex] = mGameObjects[lastIndex];
+        mIsMarked[denseIndex] = mIsMarked[lastIndex];
+        mSparse[mGameObjects[denseIndex]->GetEntityHandle().mIndex] = denseIndex;
+    }
+    mGameObjects.pop_back();
+    mIsMarked.pop_back();
+}
+
+//------------------------------------------------------------------------------
+void Group::ProcessQueues()
+{
+    for (GameObject* obj : mRemoveQueue)
+    {
+        // Skip members that were re-added after being marked
+        uint32_t denseIndex = GetDenseIndex(obj);
+        if (denseIndex != INVALID_INDEX && mIsMarked[denseIndex])
+        {
+            SwapRemove(denseIndex);
+        }
+    }
+    mRemoveQueue.clear();
+}
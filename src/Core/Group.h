@@ -3,7 +3,6 @@
 // Includes
 //------------------------------------------------------------------------------
 // System
-#include <unordered_set>
 #include <vector>
 #include <functional>
 #include <algorithm>
@@ -14,11 +13,18 @@
 class GameObject;
 class Group;
 
+//------------------------------------------------------------------------------
+class IGroupListener
+{
+public:
+    virtual void OnGameObjectRemoved(GameObject& object) = 0;
+};
+
 //------------------------------------------------------------------------------
 class GroupIterator
 {
 public:
-    explicit GroupIterator(std::vector<GameObject*>::iterator it, Group* group);
+    explicit GroupIterator(uint32_t index, uint32_t endIndex, Group* group);
     ~GroupIterator();
 
     GroupIterator& operator++();
@@ -28,55 +34,50 @@ public:
 private:
     void SkipMarked();
 
-    std::vector<GameObject*>::iterator mCurrent;
+    uint32_t mIndex;
+    uint32_t mEndIndex;
     Group* mGroup;
 };
 
 //------------------------------------------------------------------------------
+// Sparse set keyed by entity slot index, adds append and removes swap with the last member. While
+// iterating, removed members stay in place marked and are skipped, then swept once iteration ends.
+// Members added while iterating land past the iterator's end and are visited on the next pass
 class Group
 {
     friend GroupIterator;
 
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
 public:
     void AddGameObject(GameObject* obj);
     void RemoveGameObject(GameObject* obj);
     void Sort(const std::function<bool(GameObject*, GameObject*)>& compareFunc);    
+    void Clear();
+
+    // Told about every removal as it happens, including kills. Clear() stays silent
+    void SetListener(IGroupListener* listener) { mListener = listener; }
 
     GroupIterator begin()
     {
-        return GroupIterator(mSortedGameObjects.begin(), this);
+        return GroupIterator(0, static_cast<uint32_t>(mGameObjects.size()), this);
     }
 
     GroupIterator end()
     {
-        return GroupIterator(mSortedGameObjects.end(), this);
+        uint32_t endIndex = static_cast<uint32_t>(mGameObjects.size());
+        return GroupIterator(endIndex, endIndex, this);
     }
 
 private:
-    void ProcessQueues()
-    {
-        if (mIterationCounter == 0)
-        {
-            for (GameObject* obj : mAddQueue)
-            {
-                mSortedGameObjects.push_back(obj);
-            }
-            mAddQueue.clear();
+    uint32_t GetDenseIndex(const GameObject* obj) const;
+    void SwapRemove(uint32_t denseIndex);
+    void ProcessQueues();
 
-            for (GameObject* obj : mRemoveQueue)
-            {
-                auto it = std::find(mSortedGameObjects.begin(), mSortedGameObjects.end(), obj);
-                if (it != mSortedGameObjects.end())
-                {
-                    mSortedGameObjects.erase(it);
-                }
-            }
-            mRemoveQueue.clear();
-        }
-    }
-    
-    std::vector<GameObject*> mSortedGameObjects;
-    std::unordered_set<GameObject*> mRemoveQueue;
-    std::unordered_set<GameObject*> mAddQueue;
+    std::vector<uint32_t> mSparse;          // Entity slot index to position in mGameObjects
+    std::vector<GameObject*> mGameObjects;
+    std::vector<uint8_t> mIsMarked;         // Parallel to mGameObjects
+    std::vector<GameObject*> mRemoveQueue;
+    IGroupListener* mListener{ nullptr };
     uint32_t mIterationCounter{ 0 };
-};
\ No newline at end of file
+};
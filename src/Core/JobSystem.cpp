@@ -0,0 +1,243 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "JobSystem.h"
+
+// Core
+#include "AllocationTracker.h"
+
+// System
+#include <algorithm>
+#include <cassert>
+
+//------------------------------------------------------------------------------
+namespace
+{
+    // Set for the duration of a loop index on whichever thread runs it
+    struct DeferContext
+    {
+        void* mBuffer = nullptr;
+        uint32_t mIndex = 0;
+    };
+
+    thread_local DeferContext tDeferContext;
+}
+
+//------------------------------------------------------------------------------
+JobSystem::JobSystem(uint32_t workerCount)
+    : mFunc(nullptr)
+    , mRemainingChunks(0)
+    , mJobGeneration(0)
+    , mIsShuttingDown(false)
+{
+    for (uint32_t index = 0; index < workerCount + 1; index++)
+    {
+        mQueues.push_back(std::make_unique<WorkQueue>());
+    }
+    mDeferredCommands.resize(workerCount + 1);
+    for (std::vector<DeferredCommand>& buffer : mDeferredCommands)
+    {
+        buffer.reserve(INITIAL_DEFERRED_CAPACITY);
+    }
+    mMergedCommands.reserve(INITIAL_DEFERRED_CAPACITY);
+
+    for (uint32_t index = 1; index <= workerCount; index++)
+    {
+        mWorkers.emplace_back(&JobSystem::WorkerLoop, this, index);
+    }
+}
+
+//------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mIsShuttingDown = true;
+    }
+    mWakeCondition.notify_all();
+
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+/*static*/ JobSystem& JobSystem::Instance()
+{
+    // Leave a core for the main thread
+    static JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return jobSystem;
+}
+
+//------------------------------------------------------------------------------
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t index)>& func)
+{
+    assert(!IsInParallelFor());
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Publish the loop before any chunk becomes visible, workers still spinning on the previous loop may take one
+    grainSize = std::max(grainSize, 1u);
+    uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+    mFunc = &func;
+    mRemainingChunks.store(chunkCount, std::memory_order_release);
+
+    for (uint32_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        uint32_t begin = chunkIndex * grainSize;
+        WorkQueue& queue = *mQueues[chunkIndex % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        queue.mChunks.push_back({ begin, std::min(begin + grainSize, count) });
+    }
+
+    if (chunkCount > 1 && !mWorkers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            ++mJobGeneration;
+        }
+        mWakeCondition.notify_all();
+    }
+
+    while (mRemainingChunks.load(std::memory_order_acquire) > 0)
+    {
+        if (!RunChunks(0))
+        {
+            std::this_thread::yield();
+        }
+    }
+    mFunc = nullptr;
+
+    ReplayDeferredCommands();
+}
+
+//------------------------------------------------------------------------------
+/*static*/ bool JobSystem::IsInParallelFor()
+{
+    return tDeferContext.mBuffer != nullptr;
+}
+
+//------------------------------------------------------------------------------
+/*static*/ void JobSystem::PushDeferredCommand(const Command& command)
+{
+    assert(IsInParallelFor());
+    auto& buffer = *static_cast<std::vector<DeferredCommand>*>(tDeferContext.mBuffer);
+    buffer.push_back({ tDeferContext.mIndex, 0, command });
+}
+
+//------------------------------------------------------------------------------
+void JobSystem::WorkerLoop(uint32_t threadIndex)
+{
+    AllocationTracker::RegisterThread();
+
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+            mWakeCondition.wait(lock, [&]() { return mIsShuttingDown || mJobGeneration != seenGeneration; });
+            if (mIsShuttingDown)
+            {
+                AllocationTracker::UnregisterThread();
+                return;
+            }
+            seenGeneration = mJobGeneration;
+        }
+
+        while (mRemainingChunks.load(std::memory_order_acquire) > 0)
+        {
+            if (!RunChunks(threadIndex))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Runs chunks until none are left to take, returns whether any were run
+bool JobSystem::RunChunks(uint32_t threadIndex)
+{
+    bool hasRunChunk = false;
+    Chunk chunk;
+    while (PopChunk(threadIndex, chunk))
+    {
+        tDeferContext.mBuffer = &mDeferredCommands[threadIndex];
+        for (uint32_t index = chunk.mBegin; index < chunk.mEnd; index++)
+        {
+            tDeferContext.mIndex = index;
+            (*mFunc)(index);
+        }
+        tDeferContext.mBuffer = nullptr;
+
+        mRemainingChunks.fetch_sub(1, std::memory_order_acq_rel);
+        hasRunChunk = true;
+    }
+    return hasRunChunk;
+}
+
+//------------------------------------------------------------------------------
+bool JobSystem::PopChunk(uint32_t threadIndex, Chunk& chunk)
+{
+    {
+        WorkQueue& queue = *mQueues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if (!queue.IsEmpty())
+        {
+            chunk = queue.mChunks.back();
+            queue.mChunks.pop_back();
+            if (queue.IsEmpty())
+            {
+                queue.mChunks.clear();
+                queue.mHead = 0;
+            }
+            return true;
+        }
+    }
+
+    for (uint32_t offset = 1; offset < mQueues.size(); offset++)
+    {
+        WorkQueue& queue = *mQueues[(threadIndex + offset) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if (!queue.IsEmpty())
+        {
+            chunk = queue.mChunks[queue.mHead++];
+            if (queue.IsEmpty())
+            {
+                queue.mChunks.clear();
+                queue.mHead = 0;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+// Every index ran start to finish on one thread, so ordering by index and then by merge position
+// keeps each index's own commands in the order they were recorded. std::sort on the pair rather than
+// std::stable_sort, which grabs a temporary buffer from the heap
+void JobSystem::ReplayDeferredCommands()
+{
+    for (std::vector<DeferredCommand>& buffer : mDeferredCommands)
+    {
+        for (DeferredCommand& deferredCommand : buffer)
+        {
+            deferredCommand.mSequence = static_cast<uint32_t>(mMergedCommands.size());
+            mMergedCommands.push_back(deferredCommand);
+        }
+        buffer.clear();
+    }
+
+    std::sort(mMergedCommands.begin(), mMergedCommands.end(), [](const DeferredCommand& lhs, const DeferredCommand& rhs) {
+        return lhs.mIndex != rhs.mIndex ? lhs.mIndex < rhs.mIndex : lhs.mSequence < rhs.mSequence;
+    });
+
+    for (DeferredCommand& deferredCommand : mMergedCommands)
+    {
+        deferredCommand.mCommand();
+    }
+    mMergedCommands.clear();
+}
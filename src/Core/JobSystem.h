@@ -0,0 +1,120 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Fixed set of worker threads running parallel-for loops. Each loop is cut into chunks dealt out to
+// per-thread queues; threads drain their own queue from the back and steal from the front of the
+// others once it runs dry. The calling thread works too and ParallelFor returns when every chunk is done.
+//
+// Work inside a loop must not touch shared game state. Side effects go through Defer, which records
+// them per thread and replays them on the calling thread once the loop ends, ordered by loop index so
+// the outcome does not depend on which thread ran what
+class JobSystem
+{
+public:
+    // Deferred callable stored inline, so recording one never allocates. Captures must be trivially
+    // copyable and fit in STORAGE_SIZE - pointers, references and small values, not strings or containers
+    class Command
+    {
+    public:
+        static constexpr size_t STORAGE_SIZE = 48;
+
+        template<typename Func>
+        explicit Command(const Func& func)
+            : mInvoke([](void* storage) { (*static_cast<Func*>(storage))(); })
+        {
+            static_assert(sizeof(Func) <= STORAGE_SIZE, "Deferred command captures too much");
+            static_assert(alignof(Func) <= alignof(std::max_align_t), "Deferred command is over-aligned");
+            static_assert(std::is_trivially_copyable_v<Func> && std::is_trivially_destructible_v<Func>,
+                          "Deferred command captures must be trivially copyable");
+            new (mStorage) Func(func);
+        }
+
+        void operator()() { mInvoke(mStorage); }
+
+    private:
+        alignas(std::max_align_t) unsigned char mStorage[STORAGE_SIZE];
+        void (*mInvoke)(void* storage);
+    };
+
+    explicit JobSystem(uint32_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static JobSystem& Instance();
+
+    // Calls func(index) for every index in [0, count), grainSize indices per chunk
+    void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t index)>& func);
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(mQueues.size()); }
+
+    static bool IsInParallelFor();
+    template<typename Func>
+    static void Defer(const Func& func)
+    {
+        PushDeferredCommand(Command(func));
+    }
+
+private:
+    static constexpr size_t INITIAL_DEFERRED_CAPACITY = 64;
+
+    static void PushDeferredCommand(const Command& command);
+
+    struct Chunk
+    {
+        uint32_t mBegin;
+        uint32_t mEnd;
+    };
+
+    // Owner pops from the back, thieves take from mHead. Storage is kept between loops so pushing
+    // chunks does not allocate once warmed up
+    struct WorkQueue
+    {
+        std::mutex mMutex;
+        std::vector<Chunk> mChunks;
+        size_t mHead = 0;
+
+        bool IsEmpty() const { return mHead == mChunks.size(); }
+    };
+
+    struct DeferredCommand
+    {
+        uint32_t mIndex;
+        uint32_t mSequence;     // Position after merging, set on replay
+        Command mCommand;
+    };
+
+    void WorkerLoop(uint32_t threadIndex);
+    bool RunChunks(uint32_t threadIndex);
+    bool PopChunk(uint32_t threadIndex, Chunk& chunk);
+    void ReplayDeferredCommands();
+
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;                      // Index 0 belongs to the calling thread
+    std::vector<std::vector<DeferredCommand>> mDeferredCommands;          // Per thread, capacity kept between loops
+    std::vector<DeferredCommand> mMergedCommands;
+    std::vector<std::thread> mWorkers;
+
+    const std::function<void(uint32_t)>* mFunc;
+    std::atomic<uint32_t> mRemainingChunks;
+
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    uint64_t mJobGeneration;
+    bool mIsShuttingDown;
+};
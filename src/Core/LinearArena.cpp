@@ -0,0 +1,47 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "LinearArena.h"
+
+// System
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+LinearArena::LinearArena(size_t blockSize)
+    : mBlockSize(blockSize)
+    , mBlockIndex(0)
+    , mOffset(0)
+    , mBytesUsed(0)
+    , mBytesReserved(0)
+{ }
+
+//------------------------------------------------------------------------------
+void LinearArena::Reset()
+{
+    mBlockIndex = 0;
+    mOffset = 0;
+    mBytesUsed = 0;
+}
+
+//------------------------------------------------------------------------------
+void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // Walk forward through kept blocks before appending a new one, oversized requests get their own block
+    for (; mBlockIndex < mBlocks.size(); mBlockIndex++, mOffset = 0)
+    {
+        Block& block = mBlocks[mBlockIndex];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.mMemory.get());
+        uintptr_t aligned = (base + mOffset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (aligned + bytes <= base + block.mSize)
+        {
+            mOffset = aligned + bytes - base;
+            mBytesUsed += bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    size_t blockSize = std::max(mBlockSize, bytes + alignment);
+    mBlocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+    mBytesReserved += blockSize;
+    mOffset = 0;
+    return do_allocate(bytes, alignment);
+}
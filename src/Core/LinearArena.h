@@ -0,0 +1,46 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Bump allocator over a list of blocks. Deallocation is a no-op, Reset rewinds to the first block
+// and keeps every block so the next fill of the same size never goes back to the heap
+class LinearArena : public std::pmr::memory_resource
+{
+public:
+    explicit LinearArena(size_t blockSize = 64 * 1024);
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void Reset();
+
+    size_t GetBytesUsed() const { return mBytesUsed; }
+    size_t GetBytesReserved() const { return mBytesReserved; }
+    uint32_t GetBlockCount() const { return static_cast<uint32_t>(mBlocks.size()); }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> mMemory;
+        size_t mSize;
+    };
+
+    virtual void* do_allocate(size_t bytes, size_t alignment) override;
+    virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) override { }
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    size_t mBlockSize;
+    std::vector<Block> mBlocks;
+    size_t mBlockIndex;
+    size_t mOffset;
+    size_t mBytesUsed;
+    size_t mBytesReserved;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+//------------------------------------------------------------------------------
+// Types opt into pooling by specializing this with IS_POOLED = true, a CAPACITY and a NAME
+template<typename T>
+struct PoolTraits
+{
+    static constexpr bool IS_POOLED = false;
+    static constexpr uint32_t CAPACITY = 0;
+    static constexpr const char* NAME = "";
+};
+
+//------------------------------------------------------------------------------
+struct PoolStats
+{
+    const char* mName = "";
+    uint32_t mCapacity = 0;
+    uint32_t mInUse = 0;
+    uint32_t mPeakInUse = 0;
+    uint64_t mCreatedCount = 0;
+    uint64_t mRecycledCount = 0;    // Creations that reused a slot freed earlier
+    uint64_t mOverflowCount = 0;    // Creations that fell back to the heap because every slot was taken
+};
+
+//------------------------------------------------------------------------------
+class IObjectPool
+{
+public:
+    virtual ~IObjectPool() = default;
+    virtual PoolStats GetStats() const = 0;
+};
+
+//------------------------------------------------------------------------------
+// Fixed block of slots allocated once, objects are constructed in place and released slots are
+// handed out again last in first out so recently touched memory is reused first
+template<typename T>
+class ObjectPool : public IObjectPool
+{
+public:
+    ObjectPool(const char* name, uint32_t capacity)
+        : mSlots(std::make_unique<Slot[]>(capacity))
+        , mWasSlotUsed(capacity, false)
+    {
+        mStats.mName = name;
+        mStats.mCapacity = capacity;
+
+        mFreeSlots.reserve(capacity);
+        for (uint32_t index = capacity; index-- > 0; )
+        {
+            mFreeSlots.push_back(index);
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args)
+    {
+        T* object = nullptr;
+        if (mFreeSlots.empty())
+        {
+            object = new T(std::forward<Args>(args)...);
+            ++mStats.mOverflowCount;
+        }
+        else
+        {
+            uint32_t index = mFreeSlots.back();
+            object = new (mSlots[index].mBytes) T(std::forward<Args>(args)...);
+            mFreeSlots.pop_back();
+
+            if (mWasSlotUsed[index])
+            {
+                ++mStats.mRecycledCount;
+            }
+            mWasSlotUsed[index] = true;
+        }
+
+        ++mStats.mCreatedCount;
+        ++mStats.mInUse;
+        mStats.mPeakInUse = std::max(mStats.mPeakInUse, mStats.mInUse);
+        return object;
+    }
+
+    void Release(T* object)
+    {
+        const Slot* slot = reinterpret_cast<const Slot*>(object);
+        if (IsPoolSlot(slot))
+        {
+            object->~T();
+            mFreeSlots.push_back(static_cast<uint32_t>(slot - mSlots.get()));
+        }
+        else
+        {
+            delete object;
+        }
+        --mStats.mInUse;
+    }
+
+    virtual PoolStats GetStats() const override
+    {
+        return mStats;
+    }
+
+private:
+    struct Slot
+    {
+        alignas(T) std::byte mBytes[sizeof(T)];
+    };
+
+    bool IsPoolSlot(const Slot* slot) const
+    {
+        const Slot* first = mSlots.get();
+        return std::greater_equal<const Slot*>()(slot, first) && std::less<const Slot*>()(slot, first + mStats.mCapacity);
+    }
+
+    std::unique_ptr<Slot[]> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<bool> mWasSlotUsed;
+    PoolStats mStats;
+};
\ No newline at end of file
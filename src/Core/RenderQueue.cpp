@@ -0,0 +1,179 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "RenderQueue.h"
+
+// System
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Key layout, most significant first: depth (16 bits), texture (16 bits), blend mode (8 bits)
+constexpr uint32_t TEXTURE_SHIFT = 8;
+constexpr uint32_t DEPTH_SHIFT = 24;
+constexpr uint32_t KEY_BYTE_COUNT = 5;
+constexpr uint32_t RADIX = 256;
+
+//------------------------------------------------------------------------------
+void RenderQueue::Clear()
+{
+    mQuadVertices.clear();
+    mSortItems.clear();
+    mVertices.clear();
+    mBatches.clear();
+    mTextures.clear();
+    mBlendModes.clear();
+    mStats = Stats();
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::Submit(uint32_t depth, const sf::Sprite& sprite, const sf::Transform& transform, const sf::BlendMode& blendMode)
+{
+    assert(depth <= MAX_DEPTH);
+
+    uint64_t key = (static_cast<uint64_t>(depth) << DEPTH_SHIFT) |
+                   (static_cast<uint64_t>(GetTextureIndex(&sprite.getTexture())) << TEXTURE_SHIFT) |
+                   GetBlendModeIndex(blendMode);
+    mSortItems.push_back({ key, static_cast<uint32_t>(mQuadVertices.size() / VERTICES_PER_QUAD) });
+
+    // Same geometry sf::Sprite builds, already moved into world space
+    sf::IntRect textureRect = sprite.getTextureRect();
+    sf::Vector2f size(std::abs(static_cast<float>(textureRect.width)), std::abs(static_cast<float>(textureRect.height)));
+    sf::Transform combined = transform * sprite.getTransform();
+
+    float left = static_cast<float>(textureRect.left);
+    float top = static_cast<float>(textureRect.top);
+    float right = left + static_cast<float>(textureRect.width);
+    float bottom = top + static_cast<float>(textureRect.height);
+
+    sf::Vertex topLeft{ combined.transformPoint({ 0.0f, 0.0f }), sprite.getColor(), { left, top } };
+    sf::Vertex topRight{ combined.transformPoint({ size.x, 0.0f }), sprite.getColor(), { right, top } };
+    sf::Vertex bottomLeft{ combined.transformPoint({ 0.0f, size.y }), sprite.getColor(), { left, bottom } };
+    sf::Vertex bottomRight{ combined.transformPoint(size), sprite.getColor(), { right, bottom } };
+
+    for (const sf::Vertex& vertex : { topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight })
+    {
+        mQuadVertices.push_back(vertex);
+    }
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+    RadixSort();
+
+    mVertices.resize(mQuadVertices.size());
+    uint32_t vertexIndex = 0;
+    for (size_t index = 0; index < mSortItems.size(); index++)
+    {
+        const SortItem& item = mSortItems[index];
+        if (index == 0 || item.mKey != mSortItems[index - 1].mKey)
+        {
+            mBatches.push_back({ static_cast<uint32_t>(item.mKey >> DEPTH_SHIFT),
+                                 static_cast<uint32_t>((item.mKey >> TEXTURE_SHIFT) & UINT16_MAX),
+                                 static_cast<uint32_t>(item.mKey & UINT8_MAX),
+                                 vertexIndex,
+                                 0 });
+        }
+
+        const sf::Vertex* quad = &mQuadVertices[static_cast<size_t>(item.mQuadIndex) * VERTICES_PER_QUAD];
+        for (uint32_t corner = 0; corner < VERTICES_PER_QUAD; corner++)
+        {
+            mVertices[vertexIndex++] = quad[corner];
+        }
+        mBatches.back().mVertexCount += VERTICES_PER_QUAD;
+    }
+
+    mStats.mQuadCount = static_cast<uint32_t>(mSortItems.size());
+    mStats.mBatchCount = static_cast<uint32_t>(mBatches.size());
+}
+
+//------------------------------------------------------------------------------
+void RenderQueue::Draw(sf::RenderTarget& target, uint32_t depth, const sf::RenderStates& states)
+{
+    auto it = std::lower_bound(mBatches.begin(), mBatches.end(), depth, [](const Batch& batch, uint32_t value) {
+        return batch.mDepth < value;
+    });
+
+    for (; it != mBatches.end() && it->mDepth == depth; ++it)
+    {
+        sf::RenderStates batchStates(states);
+        batchStates.texture = mTextures[it->mTextureIndex];
+        batchStates.blendMode = mBlendModes[it->mBlendModeIndex];
+        target.draw(&mVertices[it->mFirstVertex], it->mVertexCount, sf::PrimitiveType::Triangles, batchStates);
+        mStats.mDrawCallCount++;
+    }
+}
+
+//------------------------------------------------------------------------------
+uint32_t RenderQueue::GetTextureIndex(const sf::Texture* texture)
+{
+    // Consecutive submits mostly share a texture, so check the last one first
+    if (!mTextures.empty() && mTextures.back() == texture)
+    {
+        return static_cast<uint32_t>(mTextures.size() - 1);
+    }
+
+    auto it = std::find(mTextures.begin(), mTextures.end(), texture);
+    if (it != mTextures.end())
+    {
+        return static_cast<uint32_t>(it - mTextures.begin());
+    }
+
+    assert(mTextures.size() < UINT16_MAX);
+    mTextures.push_back(texture);
+    return static_cast<uint32_t>(mTextures.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+uint32_t RenderQueue::GetBlendModeIndex(const sf::BlendMode& blendMode)
+{
+    auto it = std::find(mBlendModes.begin(), mBlendModes.end(), blendMode);
+    if (it != mBlendModes.end())
+    {
+        return static_cast<uint32_t>(it - mBlendModes.begin());
+    }
+
+    assert(mBlendModes.size() < UINT8_MAX);
+    mBlendModes.push_back(blendMode);
+    return static_cast<uint32_t>(mBlendModes.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+// LSD radix sort one key byte at a time. All histograms are built in a single pass, and bytes every
+// key shares are skipped - most frames only have a couple of depths, textures and blend modes
+void RenderQueue::RadixSort()
+{
+    uint32_t histograms[KEY_BYTE_COUNT][RADIX] = {};
+    for (const SortItem& item : mSortItems)
+    {
+        for (uint32_t byte = 0; byte < KEY_BYTE_COUNT; byte++)
+        {
+            histograms[byte][(item.mKey >> (byte * 8)) & (RADIX - 1)]++;
+        }
+    }
+
+    mSortScratch.resize(mSortItems.size());
+    for (uint32_t byte = 0; byte < KEY_BYTE_COUNT; byte++)
+    {
+        uint32_t* histogram = histograms[byte];
+        if (mSortItems.empty() || histogram[(mSortItems[0].mKey >> (byte * 8)) & (RADIX - 1)] == mSortItems.size())
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < RADIX; digit++)
+        {
+            uint32_t count = histogram[digit];
+            histogram[digit] = offset;
+            offset += count;
+        }
+
+        for (const SortItem& item : mSortItems)
+        {
+            mSortScratch[histogram[(item.mKey >> (byte * 8)) & (RADIX - 1)]++] = item;
+        }
+        mSortItems.swap(mSortScratch);
+    }
+}
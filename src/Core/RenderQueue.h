@@ -0,0 +1,69 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// System
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Collects sprite quads for a frame and draws them batched. Each quad gets a (depth, texture,
+// blend) sort key, a stable radix sort groups equal keys while keeping submission order inside a
+// group, and every run of equal keys becomes a single vertex array draw
+class RenderQueue
+{
+public:
+    static constexpr uint32_t MAX_DEPTH = UINT16_MAX;
+    static constexpr uint32_t VERTICES_PER_QUAD = 6;
+
+    struct Stats
+    {
+        uint32_t mQuadCount = 0;
+        uint32_t mBatchCount = 0;
+        uint32_t mDrawCallCount = 0;
+    };
+
+    // Storage is kept between frames, a warmed up queue does not allocate
+    void Clear();
+    void Submit(uint32_t depth, const sf::Sprite& sprite, const sf::Transform& transform, const sf::BlendMode& blendMode = sf::BlendAlpha);
+
+    // Call once after the last submit and before drawing
+    void Sort();
+
+    // Draws every batch at the given depth, so tile layers can be interleaved between depths
+    void Draw(sf::RenderTarget& target, uint32_t depth, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    const Stats& GetStats() const { return mStats; }
+
+private:
+    struct SortItem
+    {
+        uint64_t mKey;
+        uint32_t mQuadIndex;
+    };
+
+    struct Batch
+    {
+        uint32_t mDepth;
+        uint32_t mTextureIndex;
+        uint32_t mBlendModeIndex;
+        uint32_t mFirstVertex;
+        uint32_t mVertexCount;
+    };
+
+    uint32_t GetTextureIndex(const sf::Texture* texture);
+    uint32_t GetBlendModeIndex(const sf::BlendMode& blendMode);
+    void RadixSort();
+
+    std::vector<sf::Vertex> mQuadVertices;          // Submission order
+    std::vector<SortItem> mSortItems;
+    std::vector<SortItem> mSortScratch;
+    sf::VertexArray mVertices{ sf::PrimitiveType::Triangles };
+    std::vector<Batch> mBatches;
+    std::vector<const sf::Texture*> mTextures;      // A handful per frame, a flat list beats hashing
+    std::vector<sf::BlendMode> mBlendModes;
+    Stats mStats;
+};
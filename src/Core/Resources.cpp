@@ -6,22 +6,6 @@
 #include <unordered_map>
 #include <iostream>
 #include <stdexcept>
-#include <filesystem>
-
-namespace fs = std::filesystem;
-
-//------------------------------------------------------------------------------
-std::unique_ptr<std::vector<sf::Texture*>> LoadTexuresFromDirectory(const std::string directory)
-{
-    auto textures = std::make_unique<std::vector<sf::Texture*>>();
-
-    for (const auto& entry : fs::directory_iterator(std::string(RESOURCES_PATH) + directory))
-    {
-        std::string filepath = directory + entry.path().filename().generic_string();
-        textures->push_back(&LoadTexture(filepath));
-    }
-    return textures;
-}
 
 //------------------------------------------------------------------------------
 sf::Texture& LoadTexture(const std::string& filename)
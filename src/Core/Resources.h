@@ -10,7 +10,6 @@
 #include <string>
 
 //------------------------------------------------------------------------------
-std::unique_ptr<std::vector<sf::Texture*>> LoadTexuresFromDirectory(const std::string directory);
 sf::Texture& LoadTexture(const std::string& filename);
 const sf::Font& LoadFont(const std::string& filename);
 const sf::SoundBuffer& LoadSoundBuffer(const std::string& filename);
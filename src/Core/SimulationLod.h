@@ -0,0 +1,36 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// System
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+// How much simulation an object gets, by its distance from the view. Active objects run every tick,
+// near objects run at a reduced rate on accumulated time and dormant objects only keep their timers
+enum class SimulationLod
+{
+    ACTIVE,
+    NEAR,
+    DORMANT
+};
+
+//------------------------------------------------------------------------------
+inline SimulationLod ClassifySimulationLod(const sf::Vector2f& position, const sf::View& view, float activeMargin, float nearMargin)
+{
+    // Distance from the view rectangle along each axis, zero inside it
+    sf::Vector2f halfSize = view.getSize() / 2.0f;
+    sf::Vector2f offset = position - view.getCenter();
+    float distanceX = std::max(std::abs(offset.x) - halfSize.x, 0.0f);
+    float distanceY = std::max(std::abs(offset.y) - halfSize.y, 0.0f);
+    float distance = std::max(distanceX, distanceY);
+
+    if (distance <= activeMargin)
+    {
+        return SimulationLod::ACTIVE;
+    }
+    return distance <= nearMargin ? SimulationLod::NEAR : SimulationLod::DORMANT;
+}
@@ -0,0 +1,123 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "SpatialHash.h"
+
+// Core
+#include "GameObject.h"
+#include "Group.h"
+
+// System
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+SpatialHash::SpatialHash(float cellSize)
+    : mCellSize(cellSize)
+    , mQueryStamp(0)
+{ }
+
+//------------------------------------------------------------------------------
+void SpatialHash::Clear()
+{
+    // Cell vectors are kept so their capacity is reused by the next rebuild
+    for (std::vector<uint32_t>* cell : mOccupiedCells)
+    {
+        cell->clear();
+    }
+    mOccupiedCells.clear();
+    mEntries.clear();
+    mEntryQueryStamps.clear();
+}
+
+//------------------------------------------------------------------------------
+void SpatialHash::Insert(GameObject* object, const FloatRect& bounds, const FloatRect& previousBounds)
+{
+    uint32_t entryIndex = static_cast<uint32_t>(mEntries.size());
+    mEntries.push_back({ object, bounds, previousBounds, object->GetVelocity() });
+    mEntryQueryStamps.push_back(mQueryStamp);
+
+    sf::IntRect cellRange = GetCellRange(sf::FloatRect({ bounds.GetLeft(), bounds.GetTop() }, { bounds.GetWidth(), bounds.GetHeight() }));
+    for (int32_t cellY = cellRange.top; cellY < cellRange.top + cellRange.height; cellY++)
+    {
+        for (int32_t cellX = cellRange.left; cellX < cellRange.left + cellRange.width; cellX++)
+        {
+            std::vector<uint32_t>& cell = mCells[GetCellKey(cellX, cellY)];
+            if (cell.empty())
+            {
+                mOccupiedCells.push_back(&cell);
+            }
+            cell.push_back(entryIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void SpatialHash::Rebuild(Group& group, BoundsGetter getBounds, BoundsGetter getPreviousBounds)
+{
+    Clear();
+    for (GameObject* object : group)
+    {
+        FloatRect bounds = (object->*getBounds)();
+        Insert(object, bounds, getPreviousBounds ? (object->*getPreviousBounds)() : bounds);
+    }
+}
+
+//------------------------------------------------------------------------------
+const std::vector<const SpatialHash::Proxy*>& SpatialHash::Query(const sf::FloatRect& region) const
+{
+    ++mQueryStamp;
+    mQueryEntries.clear();
+
+    FloatRect queryRegion(region);
+    sf::IntRect cellRange = GetCellRange(region);
+    for (int32_t cellY = cellRange.top; cellY < cellRange.top + cellRange.height; cellY++)
+    {
+        for (int32_t cellX = cellRange.left; cellX < cellRange.left + cellRange.width; cellX++)
+        {
+            auto it = mCells.find(GetCellKey(cellX, cellY));
+            if (it == mCells.end())
+            {
+                continue;
+            }
+
+            for (uint32_t entryIndex : it->second)
+            {
+                if (mEntryQueryStamps[entryIndex] != mQueryStamp)
+                {
+                    mEntryQueryStamps[entryIndex] = mQueryStamp;
+                    if (mEntries[entryIndex].mBounds.FindIntersection(queryRegion))
+                    {
+                        mQueryEntries.push_back(entryIndex);
+                    }
+                }
+            }
+        }
+    }
+
+    // Keep callers deterministic regardless of which cell an object was found in first
+    std::sort(mQueryEntries.begin(), mQueryEntries.end());
+
+    mQueryResult.clear();
+    for (uint32_t entryIndex : mQueryEntries)
+    {
+        mQueryResult.push_back(&mEntries[entryIndex]);
+    }
+    return mQueryResult;
+}
+
+//------------------------------------------------------------------------------
+uint64_t SpatialHash::GetCellKey(int32_t cellX, int32_t cellY) const
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+//------------------------------------------------------------------------------
+sf::IntRect SpatialHash::GetCellRange(const sf::FloatRect& region) const
+{
+    int32_t startX = static_cast<int32_t>(std::floor(region.left / mCellSize));
+    int32_t startY = static_cast<int32_t>(std::floor(region.top / mCellSize));
+    int32_t endX = static_cast<int32_t>(std::floor((region.left + region.width) / mCellSize)) + 1;
+    int32_t endY = static_cast<int32_t>(std::floor((region.top + region.height) / mCellSize)) + 1;
+
+    return sf::IntRect({ startX, startY }, { endX - startX, endY - startY });
+}
\ No newline at end of file
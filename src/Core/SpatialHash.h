@@ -0,0 +1,60 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// Core
+#include "FloatRect.h"
+
+// System
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Forward declarations
+//------------------------------------------------------------------------------
+class GameObject;
+class Group;
+
+//------------------------------------------------------------------------------
+class SpatialHash
+{
+public:
+    using BoundsGetter = FloatRect (GameObject::*)() const;
+
+    // Bounds and motion published once per rebuild, so collision loops read plain data instead of
+    // calling back into the objects
+    struct Proxy
+    {
+        GameObject* mObject;
+        FloatRect mBounds;
+        FloatRect mPreviousBounds;
+        sf::Vector2f mVelocity;
+    };
+
+    explicit SpatialHash(float cellSize = 128.0f);
+
+    void Clear();
+    void Insert(GameObject* object, const FloatRect& bounds, const FloatRect& previousBounds);
+    void Rebuild(Group& group, BoundsGetter getBounds, BoundsGetter getPreviousBounds = nullptr);
+
+    // Proxies whose bounds overlap the region, in insertion order. The result is reused between calls
+    const std::vector<const Proxy*>& Query(const sf::FloatRect& region) const;
+
+    size_t Size() const { return mEntries.size(); }
+
+private:
+    uint64_t GetCellKey(int32_t cellX, int32_t cellY) const;
+    sf::IntRect GetCellRange(const sf::FloatRect& region) const;
+
+    float mCellSize;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> mCells;
+    std::vector<std::vector<uint32_t>*> mOccupiedCells;
+    std::vector<Proxy> mEntries;
+    mutable std::vector<uint32_t> mEntryQueryStamps;
+    mutable std::vector<uint32_t> mQueryEntries;
+    mutable std::vector<const Proxy*> mQueryResult;
+    mutable uint32_t mQueryStamp;
+};
\ No newline at end of file
@@ -4,102 +4,282 @@
 //------------------------------------------------------------------------------
 // System
 #include <algorithm>
+#include <cmath>
+#include <cassert>
+
+#if defined(__AVX2__)
+    #define COLLISION_MASK_USE_AVX2 1
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define COLLISION_MASK_USE_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+struct MaskPlacement
+{
+    const CollisionMask* mMask;
+    sf::Vector2i mPosition; // World position of the top left mask pixel
+    bool mIsMirroredX;
+    bool mIsMirroredY;
+};
 
 //------------------------------------------------------------------------------
-sf::IntRect GetTransformedBounds(const sf::Transformable& transformable, const sf::Vector2u size)
+sf::FloatRect GetTransformedBounds(const sf::Transform& transform, const sf::Vector2u size)
 {
     sf::FloatRect localBounds(sf::Vector2f(0.0f, 0.0f), sf::Vector2f(size));
-    return sf::IntRect(transformable.getTransform().transformRect(localBounds));
+    return transform.transformRect(localBounds);
 }
 
 //------------------------------------------------------------------------------
-sf::Image CreateImageFromTexture(const sf::Texture& texture, const sf::IntRect& textureRect)
+MaskPlacement PlaceMask(const CollisionMask& mask, const sf::Transform& transform)
 {
-    if (texture.getSize() != sf::Vector2u(textureRect.getSize()))
+    // Same pixel center sampling as CompareMaskPixels, solved for the first world column/row
+    const float* matrix = transform.getMatrix();
+    const sf::Vector2i size(mask.GetSize());
+
+    MaskPlacement placement;
+    placement.mMask = &mask;
+    placement.mIsMirroredX = matrix[0] < 0.0f;
+    placement.mIsMirroredY = matrix[5] < 0.0f;
+    placement.mPosition.x = placement.mIsMirroredX ? static_cast<int32_t>(std::floor(matrix[12] - 0.5f - size.x)) + 1
+                                                   : static_cast<int32_t>(std::ceil(matrix[12] - 0.5f));
+    placement.mPosition.y = placement.mIsMirroredY ? static_cast<int32_t>(std::floor(matrix[13] - 0.5f - size.y)) + 1
+                                                   : static_cast<int32_t>(std::ceil(matrix[13] - 0.5f));
+    return placement;
+}
+
+//------------------------------------------------------------------------------
+const uint64_t* GetPlacedRow(const MaskPlacement& placement, int32_t worldY)
+{
+    uint32_t localY = static_cast<uint32_t>(worldY - placement.mPosition.y);
+    if (placement.mIsMirroredY)
     {
-        sf::RenderTexture renderTexture;
-        if (!renderTexture.create(sf::Vector2u(textureRect.getSize())))
-        {
-            throw std::runtime_error("Render texture creation failed");
-        }
+        localY = placement.mMask->GetSize().y - 1 - localY;
+    }
+    return placement.mMask->GetRow(localY, placement.mIsMirroredX);
+}
 
-        // Preserve source alpha chanel
-        sf::BlendMode blendMode(sf::BlendMode::Factor::SrcColor, sf::BlendMode::Factor::Zero);
+//------------------------------------------------------------------------------
+uint64_t ExtractWord(const uint64_t* row, uint32_t bitOffset)
+{
+    uint32_t index = bitOffset / CollisionMask::BITS_PER_WORD;
+    uint32_t shift = bitOffset % CollisionMask::BITS_PER_WORD;
+    if (shift == 0)
+    {
+        return row[index];
+    }
+    return (row[index] >> shift) | (row[index + 1] << (CollisionMask::BITS_PER_WORD - shift));
+}
+
+//------------------------------------------------------------------------------
+bool IsAxisAlignedUnitScale(const sf::Transform& transform)
+{
+    const float* matrix = transform.getMatrix();
+    return matrix[1] == 0.0f && matrix[4] == 0.0f && std::abs(matrix[0]) == 1.0f && std::abs(matrix[5]) == 1.0f;
+}
 
-        renderTexture.clear();
-        renderTexture.draw(sf::Sprite(texture, textureRect), blendMode);
-        renderTexture.display();
+//------------------------------------------------------------------------------
+bool CompareMaskPixels(const CollisionMask& mask1,
+    const sf::Transform& transform1,
+    const CollisionMask& mask2,
+    const sf::Transform& transform2)
+{
+    sf::FloatRect bounds1 = GetTransformedBounds(transform1, mask1.GetSize());
+    sf::FloatRect bounds2 = GetTransformedBounds(transform2, mask2.GetSize());
 
-        return renderTexture.getTexture().copyToImage();
+    std::optional<sf::FloatRect> compareBounds = bounds1.findIntersection(bounds2);
+    if (!compareBounds)
+    {
+        return false;
     }
-    else
+
+    int32_t left = static_cast<int32_t>(std::floor(compareBounds->left));
+    int32_t top = static_cast<int32_t>(std::floor(compareBounds->top));
+    int32_t right = static_cast<int32_t>(std::ceil(compareBounds->left + compareBounds->width));
+    int32_t bottom = static_cast<int32_t>(std::ceil(compareBounds->top + compareBounds->height));
+
+    sf::Transform inverseTransform1 = transform1.getInverse();
+    sf::Transform inverseTransform2 = transform2.getInverse();
+
+    for (int32_t y = top; y < bottom; ++y)
     {
-        return texture.copyToImage();
+        for (int32_t x = left; x < right; ++x)
+        {
+            // Sample world pixel centers so mirrored masks keep their first column
+            sf::Vector2f globalPos = sf::Vector2f(x + 0.5f, y + 0.5f);
+            sf::Vector2f localPos1 = inverseTransform1.transformPoint(globalPos);
+            sf::Vector2f localPos2 = inverseTransform2.transformPoint(globalPos);
+
+            // Out of bounds positions read as transparent
+            if (mask1.TestBit({ static_cast<int32_t>(std::floor(localPos1.x)), static_cast<int32_t>(std::floor(localPos1.y)) }) &&
+                mask2.TestBit({ static_cast<int32_t>(std::floor(localPos2.x)), static_cast<int32_t>(std::floor(localPos2.y)) }))
+            {
+                return true;
+            }
+        }
     }
+    return false;
 }
 
 //------------------------------------------------------------------------------
-bool ComparePixels(const sf::Image& image1,
-    const sf::Image& image2,
-    const sf::IntRect& compareBounds,
-    const sf::Transform& inverseTransform1,
-    const sf::Transform& inverseTransform2)
+bool CompareMaskRows(const CollisionMask& mask1,
+    const sf::Transform& transform1,
+    const CollisionMask& mask2,
+    const sf::Transform& transform2)
 {
-    for (int32_t y = compareBounds.top; y < compareBounds.top + compareBounds.height; ++y)
+    assert(IsAxisAlignedUnitScale(transform1) && IsAxisAlignedUnitScale(transform2));
+
+    MaskPlacement placement1 = PlaceMask(mask1, transform1);
+    MaskPlacement placement2 = PlaceMask(mask2, transform2);
+
+    sf::Vector2i size1(mask1.GetSize());
+    sf::Vector2i size2(mask2.GetSize());
+
+    int32_t left = std::max(placement1.mPosition.x, placement2.mPosition.x);
+    int32_t top = std::max(placement1.mPosition.y, placement2.mPosition.y);
+    int32_t right = std::min(placement1.mPosition.x + size1.x, placement2.mPosition.x + size2.x);
+    int32_t bottom = std::min(placement1.mPosition.y + size1.y, placement2.mPosition.y + size2.y);
+
+    if (left >= right || top >= bottom)
+    {
+        return false;
+    }
+
+    // Bits read past the overlap's right edge always fall beyond one of the two masks' widths,
+    // where the padded rows are zero, so the last word needs no trimming
+    uint32_t offset1 = static_cast<uint32_t>(left - placement1.mPosition.x);
+    uint32_t offset2 = static_cast<uint32_t>(left - placement2.mPosition.x);
+    uint32_t wordCount = static_cast<uint32_t>(right - left + CollisionMask::BITS_PER_WORD - 1) / CollisionMask::BITS_PER_WORD;
+
+    int32_t y = top;
+
+#if defined(COLLISION_MASK_USE_AVX2)
+    // Four rows per step - every row of a mask shares the same shift, so a single vector shift covers them
+    for (; y + 4 <= bottom; y += 4)
     {
-        for (int32_t x = compareBounds.left; x < compareBounds.left + compareBounds.width; ++x)
+        const uint64_t* rows1[4];
+        const uint64_t* rows2[4];
+        for (int32_t lane = 0; lane < 4; lane++)
         {
-            sf::Vector2f globalPos = sf::Vector2f(static_cast<float>(x), static_cast<float>(y));
-            sf::Vector2i localPos1 = sf::Vector2i(inverseTransform1.transformPoint(globalPos));
-            sf::Vector2i localPos2 = sf::Vector2i(inverseTransform2.transformPoint(globalPos));
+            rows1[lane] = GetPlacedRow(placement1, y + lane);
+            rows2[lane] = GetPlacedRow(placement2, y + lane);
+        }
 
-            sf::Vector2u imageSize1 = image1.getSize();
-            sf::Vector2u imageSize2 = image2.getSize();
+        __m256i accumulator = _mm256_setzero_si256();
+        for (uint32_t word = 0; word < wordCount; word++)
+        {
+            uint32_t bitOffset1 = offset1 + word * CollisionMask::BITS_PER_WORD;
+            uint32_t bitOffset2 = offset2 + word * CollisionMask::BITS_PER_WORD;
+            uint32_t index1 = bitOffset1 / CollisionMask::BITS_PER_WORD;
+            uint32_t index2 = bitOffset2 / CollisionMask::BITS_PER_WORD;
+            __m128i shift1 = _mm_cvtsi32_si128(bitOffset1 % CollisionMask::BITS_PER_WORD);
+            __m128i shift2 = _mm_cvtsi32_si128(bitOffset2 % CollisionMask::BITS_PER_WORD);
+            __m128i inverseShift1 = _mm_cvtsi32_si128(CollisionMask::BITS_PER_WORD - bitOffset1 % CollisionMask::BITS_PER_WORD);
+            __m128i inverseShift2 = _mm_cvtsi32_si128(CollisionMask::BITS_PER_WORD - bitOffset2 % CollisionMask::BITS_PER_WORD);
 
-            bool isInImage1Bounds = (0 <= localPos1.x && localPos1.x < imageSize1.x && 0 <= localPos1.y && localPos1.y < imageSize1.y);
-            bool isInImage2Bounds = (0 <= localPos2.x && localPos2.x < imageSize2.x && 0 <= localPos2.y && localPos2.y < imageSize2.y);
+            // A shift count of 64 yields zero, which covers word aligned offsets
+            __m256i words1 = _mm256_or_si256(
+                _mm256_srl_epi64(_mm256_set_epi64x(rows1[3][index1], rows1[2][index1], rows1[1][index1], rows1[0][index1]), shift1),
+                _mm256_sll_epi64(_mm256_set_epi64x(rows1[3][index1 + 1], rows1[2][index1 + 1], rows1[1][index1 + 1], rows1[0][index1 + 1]), inverseShift1));
+            __m256i words2 = _mm256_or_si256(
+                _mm256_srl_epi64(_mm256_set_epi64x(rows2[3][index2], rows2[2][index2], rows2[1][index2], rows2[0][index2]), shift2),
+                _mm256_sll_epi64(_mm256_set_epi64x(rows2[3][index2 + 1], rows2[2][index2 + 1], rows2[1][index2 + 1], rows2[0][index2 + 1]), inverseShift2));
 
-            if (isInImage1Bounds && isInImage2Bounds)
-            {
-                sf::Color pixel1 = image1.getPixel(sf::Vector2u(localPos1));
-                sf::Color pixel2 = image2.getPixel(sf::Vector2u(localPos2));
+            accumulator = _mm256_or_si256(accumulator, _mm256_and_si256(words1, words2));
+        }
+
+        if (!_mm256_testz_si256(accumulator, accumulator))
+        {
+            return true;
+        }
+    }
+#elif defined(COLLISION_MASK_USE_SSE2)
+    // Two rows per step - every row of a mask shares the same shift, so a single vector shift covers them
+    for (; y + 2 <= bottom; y += 2)
+    {
+        const uint64_t* row10 = GetPlacedRow(placement1, y);
+        const uint64_t* row11 = GetPlacedRow(placement1, y + 1);
+        const uint64_t* row20 = GetPlacedRow(placement2, y);
+        const uint64_t* row21 = GetPlacedRow(placement2, y + 1);
+
+        __m128i accumulator = _mm_setzero_si128();
+        for (uint32_t word = 0; word < wordCount; word++)
+        {
+            uint32_t bitOffset1 = offset1 + word * CollisionMask::BITS_PER_WORD;
+            uint32_t bitOffset2 = offset2 + word * CollisionMask::BITS_PER_WORD;
+            uint32_t index1 = bitOffset1 / CollisionMask::BITS_PER_WORD;
+            uint32_t index2 = bitOffset2 / CollisionMask::BITS_PER_WORD;
+            __m128i shift1 = _mm_cvtsi32_si128(bitOffset1 % CollisionMask::BITS_PER_WORD);
+            __m128i shift2 = _mm_cvtsi32_si128(bitOffset2 % CollisionMask::BITS_PER_WORD);
+            __m128i inverseShift1 = _mm_cvtsi32_si128(CollisionMask::BITS_PER_WORD - bitOffset1 % CollisionMask::BITS_PER_WORD);
+            __m128i inverseShift2 = _mm_cvtsi32_si128(CollisionMask::BITS_PER_WORD - bitOffset2 % CollisionMask::BITS_PER_WORD);
+
+            // A shift count of 64 yields zero, which covers word aligned offsets
+            __m128i words1 = _mm_or_si128(
+                _mm_srl_epi64(_mm_set_epi64x(row11[index1], row10[index1]), shift1),
+                _mm_sll_epi64(_mm_set_epi64x(row11[index1 + 1], row10[index1 + 1]), inverseShift1));
+            __m128i words2 = _mm_or_si128(
+                _mm_srl_epi64(_mm_set_epi64x(row21[index2], row20[index2]), shift2),
+                _mm_sll_epi64(_mm_set_epi64x(row21[index2 + 1], row20[index2 + 1]), inverseShift2));
+
+            accumulator = _mm_or_si128(accumulator, _mm_and_si128(words1, words2));
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(accumulator, _mm_setzero_si128())) != 0xFFFF)
+        {
+            return true;
+        }
+    }
+#endif
+
+    for (; y < bottom; ++y)
+    {
+        const uint64_t* row1 = GetPlacedRow(placement1, y);
+        const uint64_t* row2 = GetPlacedRow(placement2, y);
 
-                if (pixel1.a != 0 && pixel2.a != 0)
-                {
-                    return true;
-                }
+        for (uint32_t word = 0; word < wordCount; word++)
+        {
+            uint32_t bitOffset = word * CollisionMask::BITS_PER_WORD;
+            if (ExtractWord(row1, offset1 + bitOffset) & ExtractWord(row2, offset2 + bitOffset))
+            {
+                return true;
             }
         }
     }
+
     return false;
 }
 
 //------------------------------------------------------------------------------
-bool BitmaskCompare(const sf::Texture& texture1,
-    const sf::IntRect& textureRect1,
+bool BitmaskCompare(const CollisionMask& mask1,
     const sf::Transformable& transformable1,
-    const sf::Texture& texture2,
-    const sf::IntRect& textureRect2,
+    const CollisionMask& mask2,
     const sf::Transformable& transformable2)
 {
+    const sf::Transform& transform1 = transformable1.getTransform();
+    const sf::Transform& transform2 = transformable2.getTransform();
 
-    sf::Image image1 = CreateImageFromTexture(texture1, textureRect1);
-    sf::Image image2 = CreateImageFromTexture(texture2, textureRect2);
-
-    sf::IntRect bounds1 = GetTransformedBounds(transformable1, image1.getSize());
-    sf::IntRect bounds2 = GetTransformedBounds(transformable2, image2.getSize());
-
-    std::optional<sf::IntRect> compareBounds = bounds1.findIntersection(bounds2);
-    if (!compareBounds)
+    // Sprites in this game are only ever mirrored, so the per pixel path is reserved for real rotation or scale
+    if (IsAxisAlignedUnitScale(transform1) && IsAxisAlignedUnitScale(transform2))
     {
-        return false;
+        return CompareMaskRows(mask1, transform1, mask2, transform2);
     }
+    return CompareMaskPixels(mask1, transform1, mask2, transform2);
+}
 
-    return ComparePixels(image1,
-        image2,
-        compareBounds.value(),
-        transformable1.getInverseTransform(),
-        transformable2.getInverseTransform());
+//------------------------------------------------------------------------------
+bool BitmaskCompare(const sf::Texture& texture1,
+    const sf::IntRect& textureRect1,
+    const sf::Transformable& transformable1,
+    const sf::Texture& texture2,
+    const sf::IntRect& textureRect2,
+    const sf::Transformable& transformable2)
+{
+    return BitmaskCompare(LoadCollisionMask(texture1, textureRect1),
+        transformable1,
+        LoadCollisionMask(texture2, textureRect2),
+        transformable2);
 }
 
 //------------------------------------------------------------------------------
@@ -1,9 +1,27 @@
+#pragma once
+
 // Includes
 //------------------------------------------------------------------------------
 // Third party
 #include <SFML/Graphics.hpp>
 
+// Core
+#include "CollisionMask.h"
+
 //------------------------------------------------------------------------------
+bool IsAxisAlignedUnitScale(const sf::Transform& transform);
+bool CompareMaskPixels(const CollisionMask& mask1,
+    const sf::Transform& transform1,
+    const CollisionMask& mask2,
+    const sf::Transform& transform2);
+bool CompareMaskRows(const CollisionMask& mask1,
+    const sf::Transform& transform1,
+    const CollisionMask& mask2,
+    const sf::Transform& transform2);
+bool BitmaskCompare(const CollisionMask& mask1,
+    const sf::Transformable& transformable1,
+    const CollisionMask& mask2,
+    const sf::Transformable& transformable2);
 bool BitmaskCompare(const sf::Texture& texture1,
     const sf::IntRect& textureRect1,
     const sf::Transformable& transformable1,
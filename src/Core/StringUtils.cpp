@@ -3,26 +3,27 @@
 // Includes
 //------------------------------------------------------------------------------
 // System
-#include <sstream>
-#include <vector>
+#include <stdexcept>
 
+// Walks the delimiters in place rather than tokenizing, elements follow std::getline splitting so a
+// trailing delimiter does not start an empty element
 std::string SplitAndGetElement(const std::string& input, char delimiter, int index)
 {
-    std::istringstream iss(input);
-    std::vector<std::string> tokens;
-    std::string token;
-
-    while (std::getline(iss, token, delimiter))
+    size_t elementStart = 0;
+    for (int elementIndex = 0; index >= 0 && elementStart < input.size(); elementIndex++)
     {
-        tokens.push_back(token);
-    }
+        size_t elementEnd = input.find(delimiter, elementStart);
+        if (elementEnd == std::string::npos)
+        {
+            elementEnd = input.size();
+        }
 
-    if (index >= 0 && index < tokens.size())
-    {
-        return tokens[index];
+        if (elementIndex == index)
+        {
+            return input.substr(elementStart, elementEnd - elementStart);
+        }
+        elementStart = elementEnd + 1;
     }
-    else
-    {
-        throw std::out_of_range("Index is out of bounds.");
-    }
-}
\ No newline at end of file
+
+    throw std::out_of_range("Index is out of bounds.");
+}
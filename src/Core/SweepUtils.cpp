@@ -0,0 +1,80 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "SweepUtils.h"
+
+// System
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+FloatRect GetSweptBounds(const FloatRect& moving, const sf::Vector2f& displacement)
+{
+    float left = std::min(moving.GetLeft(), moving.GetLeft() + displacement.x);
+    float top = std::min(moving.GetTop(), moving.GetTop() + displacement.y);
+    sf::Vector2f size(moving.GetWidth() + std::abs(displacement.x), moving.GetHeight() + std::abs(displacement.y));
+    return FloatRect({ left, top }, size);
+}
+
+//------------------------------------------------------------------------------
+FloatRect GetSweptBounds(const FloatRect& previousHitbox, const FloatRect& hitbox)
+{
+    return GetSweptBounds(previousHitbox, GetHitboxDisplacement(previousHitbox, hitbox));
+}
+
+//------------------------------------------------------------------------------
+sf::Vector2f GetHitboxDisplacement(const FloatRect& previousHitbox, const FloatRect& hitbox)
+{
+    return sf::Vector2f(hitbox.GetLeft() - previousHitbox.GetLeft(), hitbox.GetTop() - previousHitbox.GetTop());
+}
+
+//------------------------------------------------------------------------------
+// Entry and exit time of one axis slab, infinite when the axis does not move but already overlaps
+static bool SweepAxis(float movingMin, float movingMax, float displacement, float targetMin, float targetMax,
+                      float& entryTime, float& exitTime)
+{
+    if (displacement > 0.0f)
+    {
+        entryTime = (targetMin - movingMax) / displacement;
+        exitTime = (targetMax - movingMin) / displacement;
+    }
+    else if (displacement < 0.0f)
+    {
+        entryTime = (targetMax - movingMin) / displacement;
+        exitTime = (targetMin - movingMax) / displacement;
+    }
+    else
+    {
+        if (movingMax <= targetMin || movingMin >= targetMax)
+        {
+            return false;
+        }
+        entryTime = -std::numeric_limits<float>::infinity();
+        exitTime = std::numeric_limits<float>::infinity();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+std::optional<float> SweepRect(const FloatRect& moving, const sf::Vector2f& displacement, const FloatRect& target)
+{
+    if (moving.FindIntersection(target))
+    {
+        return 0.0f;
+    }
+
+    float entryX, exitX, entryY, exitY;
+    if (!SweepAxis(moving.GetLeft(), moving.GetRight(), displacement.x, target.GetLeft(), target.GetRight(), entryX, exitX) ||
+        !SweepAxis(moving.GetTop(), moving.GetBottom(), displacement.y, target.GetTop(), target.GetBottom(), entryY, exitY))
+    {
+        return std::nullopt;
+    }
+
+    float entryTime = std::max(entryX, entryY);
+    float exitTime = std::min(exitX, exitY);
+    if (entryTime >= exitTime || entryTime < 0.0f || entryTime > 1.0f)
+    {
+        return std::nullopt;
+    }
+    return entryTime;
+}
\ No newline at end of file
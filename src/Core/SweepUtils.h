@@ -0,0 +1,21 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// Core
+#include "FloatRect.h"
+
+// System
+#include <optional>
+
+//------------------------------------------------------------------------------
+FloatRect GetSweptBounds(const FloatRect& moving, const sf::Vector2f& displacement);
+FloatRect GetSweptBounds(const FloatRect& previousHitbox, const FloatRect& hitbox);
+sf::Vector2f GetHitboxDisplacement(const FloatRect& previousHitbox, const FloatRect& hitbox);
+
+// Fraction of the displacement in [0, 1] at which the moving box first overlaps the target,
+// 0 when they already overlap and nullopt when they stay apart or only graze
+std::optional<float> SweepRect(const FloatRect& moving, const sf::Vector2f& displacement, const FloatRect& target);
\ No newline at end of file
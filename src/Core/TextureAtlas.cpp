@@ -0,0 +1,188 @@
+#include "TextureAtlas.h"
+
+// Includes
+//------------------------------------------------------------------------------
+// Core
+#include "Resources.h"
+#include "CollisionMask.h"
+
+// System
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+//------------------------------------------------------------------------------
+struct PackedImage
+{
+    std::string mFilename;
+    sf::Image mImage;
+    uint32_t mPageIndex;
+    sf::Vector2u mPosition;
+};
+
+//------------------------------------------------------------------------------
+static TextureAtlas& GetAtlasStore()
+{
+    static TextureAtlas textureAtlas;
+    return textureAtlas;
+}
+
+//------------------------------------------------------------------------------
+void TextureAtlas::Build(const std::vector<std::string>& filenames)
+{
+    std::vector<PackedImage> images;
+    images.reserve(filenames.size());
+    for (const std::string& filename : filenames)
+    {
+        PackedImage packedImage{ filename };
+        if (!packedImage.mImage.loadFromFile(std::string(RESOURCES_PATH) + filename))
+        {
+            throw std::runtime_error("Failed to load texture: " + filename);
+        }
+
+        sf::Vector2u size = packedImage.mImage.getSize();
+        if (size.x + PADDING <= PAGE_SIZE && size.y + PADDING <= PAGE_SIZE)
+        {
+            images.push_back(std::move(packedImage));
+        }
+    }
+
+    std::stable_sort(images.begin(), images.end(), [](const PackedImage& a, const PackedImage& b) {
+        return a.mImage.getSize().y > b.mImage.getSize().y;
+    });
+
+    // Shelf layout, only positions are decided here so each page can be sized to its content
+    uint32_t pageIndex = static_cast<uint32_t>(mPages.size());
+    std::vector<sf::Vector2u> pageExtents(1);
+    sf::Vector2u cursor(PADDING, PADDING);
+    uint32_t shelfHeight = 0;
+    for (PackedImage& packedImage : images)
+    {
+        sf::Vector2u size = packedImage.mImage.getSize();
+        if (cursor.x + size.x + PADDING > PAGE_SIZE)
+        {
+            cursor = { PADDING, cursor.y + shelfHeight + PADDING };
+            shelfHeight = 0;
+        }
+        if (cursor.y + size.y + PADDING > PAGE_SIZE)
+        {
+            pageExtents.emplace_back();
+            cursor = { PADDING, PADDING };
+            shelfHeight = 0;
+        }
+
+        packedImage.mPageIndex = pageIndex + static_cast<uint32_t>(pageExtents.size() - 1);
+        packedImage.mPosition = cursor;
+
+        sf::Vector2u& extent = pageExtents.back();
+        extent.x = std::max(extent.x, cursor.x + size.x + PADDING);
+        extent.y = std::max(extent.y, cursor.y + size.y + PADDING);
+
+        cursor.x += size.x + PADDING;
+        shelfHeight = std::max(shelfHeight, size.y);
+    }
+
+    if (images.empty())
+    {
+        return;
+    }
+
+    // Compose each page on the CPU and upload it once. The page image is still at hand, so the
+    // collision masks are built from it instead of reading every frame back from the GPU later
+    for (uint32_t extentIndex = 0; extentIndex < pageExtents.size(); extentIndex++)
+    {
+        sf::Image pageImage;
+        pageImage.create(pageExtents[extentIndex], sf::Color::Transparent);
+
+        uint32_t page = pageIndex + extentIndex;
+        for (const PackedImage& packedImage : images)
+        {
+            if (packedImage.mPageIndex == page)
+            {
+                pageImage.copy(packedImage.mImage, packedImage.mPosition);
+            }
+        }
+
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromImage(pageImage))
+        {
+            throw std::runtime_error("Failed to create atlas page " + std::to_string(page));
+        }
+
+        for (const PackedImage& packedImage : images)
+        {
+            if (packedImage.mPageIndex == page)
+            {
+                AtlasRegion region{ texture.get(), sf::IntRect(sf::Vector2i(packedImage.mPosition),
+                                                               sf::Vector2i(packedImage.mImage.getSize())) };
+                mRegions[packedImage.mFilename] = region;
+                LoadCollisionMask(*region.mTexture, region.mTextureRect, pageImage);
+            }
+        }
+
+        mPages.push_back(std::move(texture));
+    }
+}
+
+//------------------------------------------------------------------------------
+const AtlasRegion* TextureAtlas::FindRegion(const std::string& filename) const
+{
+    auto it = mRegions.find(filename);
+    return it != mRegions.end() ? &it->second : nullptr;
+}
+
+//------------------------------------------------------------------------------
+void BuildTextureAtlas(const std::vector<std::string>& sources)
+{
+    std::vector<std::string> filenames;
+    for (const std::string& source : sources)
+    {
+        fs::path path = fs::path(RESOURCES_PATH) / source;
+        if (!fs::is_directory(path))
+        {
+            filenames.push_back(source);
+            continue;
+        }
+
+        for (const auto& entry : fs::recursive_directory_iterator(path))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".png")
+            {
+                filenames.push_back(source + "/" + fs::relative(entry.path(), path).generic_string());
+            }
+        }
+    }
+
+    GetAtlasStore().Build(filenames);
+}
+
+//------------------------------------------------------------------------------
+AtlasRegion LoadAtlasRegion(const std::string& filename)
+{
+    if (const AtlasRegion* region = GetAtlasStore().FindRegion(filename))
+    {
+        return *region;
+    }
+
+    const sf::Texture& texture = LoadTexture(filename);
+    return { &texture, sf::IntRect({ 0, 0 }, sf::Vector2i(texture.getSize())) };
+}
+
+//------------------------------------------------------------------------------
+std::vector<AtlasRegion> LoadAtlasRegionsFromDirectory(const std::string& directory)
+{
+    std::vector<AtlasRegion> regions;
+    for (const auto& entry : fs::directory_iterator(std::string(RESOURCES_PATH) + directory))
+    {
+        regions.push_back(LoadAtlasRegion(directory + entry.path().filename().generic_string()));
+    }
+    return regions;
+}
+
+//------------------------------------------------------------------------------
+const TextureAtlas& GetTextureAtlas()
+{
+    return GetAtlasStore();
+}
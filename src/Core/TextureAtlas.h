@@ -0,0 +1,61 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/Graphics.hpp>
+
+// System
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// A frame inside an atlas page, sprites sharing a page can be drawn in one batch
+struct AtlasRegion
+{
+    const sf::Texture* mTexture;
+    sf::IntRect mTextureRect;
+};
+
+//------------------------------------------------------------------------------
+// Packs individual images onto a few large pages with a shelf packer. Images are sorted tallest
+// first and laid out in rows, a new page is opened once a row no longer fits
+class TextureAtlas
+{
+public:
+    static constexpr uint32_t PAGE_SIZE = 1024;
+    static constexpr uint32_t PADDING = 2; // Transparent gap so neighbouring frames never bleed in
+
+    // Filenames are relative to RESOURCES_PATH, images larger than a page are left out
+    void Build(const std::vector<std::string>& filenames);
+
+    const AtlasRegion* FindRegion(const std::string& filename) const;
+
+    size_t GetPageCount() const
+    {
+        return mPages.size();
+    }
+
+private:
+    std::vector<std::unique_ptr<sf::Texture>> mPages;
+    std::unordered_map<std::string, AtlasRegion> mRegions;
+};
+
+//------------------------------------------------------------------------------
+// Packs the given files, directories are searched recursively. Call once the render window exists
+// and before any region is loaded, collision masks for every packed frame are built on the way
+void BuildTextureAtlas(const std::vector<std::string>& sources);
+
+// Regions of files missing from the atlas cover their own standalone texture
+AtlasRegion LoadAtlasRegion(const std::string& filename);
+std::vector<AtlasRegion> LoadAtlasRegionsFromDirectory(const std::string& directory);
+const TextureAtlas& GetTextureAtlas();
+
+//------------------------------------------------------------------------------
+inline sf::Sprite CreateSprite(const AtlasRegion& region)
+{
+    return sf::Sprite(*region.mTexture, region.mTextureRect);
+}
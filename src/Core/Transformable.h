@@ -5,6 +5,9 @@
 // Third party
 #include <SFML/Graphics.hpp>
 
+// Core
+#include "FloatRect.h"
+
 //------------------------------------------------------------------------------
 class Tranformable
 {
@@ -12,16 +15,40 @@ public:
     virtual void SetPosition(const sf::Vector2f& position)
     {
         mTransformable.setPosition(position);
+        MarkWorldBoundsDirty();
     }
     
     void SetOrigin(const sf::Vector2f& origin)
     {
         mTransformable.setOrigin(origin);
+        MarkWorldBoundsDirty();
     }
 
     void SetScale(const sf::Vector2f& factors)
     {
         mTransformable.setScale(factors);
+        MarkWorldBoundsDirty();
+    }
+
+    // Untransformed bounds of whatever is drawn, set again whenever the sprite's frame changes
+    void SetLocalBounds(const sf::FloatRect& localBounds)
+    {
+        if (localBounds != mLocalBounds)
+        {
+            mLocalBounds = localBounds;
+            MarkWorldBoundsDirty();
+        }
+    }
+
+    // Local bounds transformed to an axis aligned box, recomputed only after the transform or bounds change
+    const FloatRect& GetWorldBounds() const
+    {
+        if (mIsWorldBoundsDirty)
+        {
+            mWorldBounds = GetTransform().transformRect(mLocalBounds);
+            mIsWorldBoundsDirty = false;
+        }
+        return mWorldBounds;
     }
 
     const sf::Vector2f& GetPosition() const
@@ -34,11 +61,27 @@ public:
         return mTransformable.getTransform();
     }
 
-    sf::Transformable& GetInternaleTransformable()
+    const sf::Transformable& GetInternaleTransformable() const
     {
         return mTransformable;
     }
 
+protected:
+    // Called when cached world bounds go stale, once until they are recomputed. May run on a job thread
+    virtual void OnWorldBoundsDirty() { }
+
 private:
+    void MarkWorldBoundsDirty()
+    {
+        if (!mIsWorldBoundsDirty)
+        {
+            mIsWorldBoundsDirty = true;
+            OnWorldBoundsDirty();
+        }
+    }
+
     sf::Transformable mTransformable;
-};
\ No newline at end of file
+    sf::FloatRect mLocalBounds;
+    mutable FloatRect mWorldBounds;
+    mutable bool mIsWorldBoundsDirty = true;
+};
@@ -0,0 +1,24 @@
+// Includes
+//------------------------------------------------------------------------------
+#include "UpdateScheduler.h"
+
+//------------------------------------------------------------------------------
+void UpdateScheduler::Clear()
+{
+    for (Batch& batch : mBatches)
+    {
+        batch.mObjects->Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+void UpdateScheduler::Update(uint32_t phase, const sf::Time& timeslice)
+{
+    for (Batch& batch : mBatches)
+    {
+        if (batch.mPhase == phase)
+        {
+            batch.mUpdate(*batch.mObjects, timeslice);
+        }
+    }
+}
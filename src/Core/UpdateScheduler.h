@@ -0,0 +1,121 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Third party
+#include <SFML/System/Time.hpp>
+
+// Core
+#include "Group.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+
+// System
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+
+//------------------------------------------------------------------------------
+// Parallel batches spread their objects over the job system, so T::Update must only touch the object
+// itself and read shared state; kills, spawns and sounds are deferred to the main thread
+enum class UpdateMode
+{
+    SERIAL,
+    PARALLEL
+};
+
+//------------------------------------------------------------------------------
+// Updates objects in batches of one concrete type, each batch running a loop instantiated for that
+// type that calls T::Update without virtual dispatch. Phases run when the owner asks for them, and
+// within a phase batches run in registration order, so ordering stays deterministic
+class UpdateScheduler
+{
+    static constexpr uint32_t PARALLEL_GRAIN_SIZE = 32;
+
+    using BatchUpdateFunc = void(*)(Group& objects, const sf::Time& timeslice);
+
+    struct Batch
+    {
+        uint32_t mPhase;
+        std::unique_ptr<Group> mObjects;    // Groups are tracked by address, so they must not move
+        BatchUpdateFunc mUpdate;
+    };
+
+    static constexpr uint32_t UNREGISTERED = UINT32_MAX;
+
+public:
+    template<typename T, typename Phase>
+    void RegisterType(Phase phase, UpdateMode mode = UpdateMode::SERIAL)
+    {
+        uint32_t typeIndex = GetTypeIndex<T>();
+        if (typeIndex >= mBatchIndices.size())
+        {
+            mBatchIndices.resize(typeIndex + 1, UNREGISTERED);
+        }
+        assert(mBatchIndices[typeIndex] == UNREGISTERED);
+
+        mBatchIndices[typeIndex] = static_cast<uint32_t>(mBatches.size());
+        BatchUpdateFunc update = mode == UpdateMode::PARALLEL ? &UpdateBatchParallel<T> : &UpdateBatch<T>;
+        mBatches.push_back({ static_cast<uint32_t>(phase), std::make_unique<Group>(), update });
+    }
+
+    template<typename T>
+    void AddGameObject(T* object)
+    {
+        uint32_t typeIndex = GetTypeIndex<T>();
+        assert(typeIndex < mBatchIndices.size() && mBatchIndices[typeIndex] != UNREGISTERED);
+        mBatches[mBatchIndices[typeIndex]].mObjects->AddGameObject(object);
+    }
+
+    template<typename Phase>
+    void Update(Phase phase, const sf::Time& timeslice)
+    {
+        Update(static_cast<uint32_t>(phase), timeslice);
+    }
+
+    void Clear();
+
+private:
+    void Update(uint32_t phase, const sf::Time& timeslice);
+
+    template<typename T>
+    static void UpdateBatch(Group& objects, const sf::Time& timeslice)
+    {
+        for (GameObject* object : objects)
+        {
+            static_cast<T*>(object)->T::Update(timeslice);
+        }
+    }
+
+    template<typename T>
+    static void UpdateBatchParallel(Group& objects, const sf::Time& timeslice)
+    {
+        // Snapshot the members so workers can index them, kills are deferred so the group holds still
+        std::pmr::vector<T*> snapshot(&GetFrameArena());
+        for (GameObject* object : objects)
+        {
+            snapshot.push_back(static_cast<T*>(object));
+        }
+
+        JobSystem::Instance().ParallelFor(static_cast<uint32_t>(snapshot.size()), PARALLEL_GRAIN_SIZE, [&](uint32_t index) {
+            snapshot[index]->T::Update(timeslice);
+        });
+    }
+
+    static uint32_t NextTypeIndex()
+    {
+        static uint32_t sTypeCounter = 0;
+        return sTypeCounter++;
+    }
+
+    template<typename T>
+    static uint32_t GetTypeIndex()
+    {
+        static const uint32_t sTypeIndex = NextTypeIndex();
+        return sTypeIndex;
+    }
+
+    std::vector<Batch> mBatches;
+    std::vector<uint32_t> mBatchIndices;    // Type index to batch
+};
@@ -6,18 +6,41 @@
 #include "Entity.h"
 #include "Player.h"
 
+// Core
+#include "Core/SimulationLod.h"
+
 //------------------------------------------------------------------------------
 class Enemy : public Entity
 {
+    static constexpr float BULLET_SPAWN_OFFSET = 40.0f;
+
+    // Active past the view edge covers the fire range, near enemies think at a quarter of the tick rate
+    static constexpr float ACTIVE_LOD_MARGIN = 200.0f;
+    static constexpr float NEAR_LOD_MARGIN = 1200.0f;
+    static constexpr float NEAR_LOD_INTERVAL = 4.0f / SIMULATION_TICK_RATE;
+
 public:
-    Enemy(const sf::Vector2f& position, Player& player, TiledLayerSpatialQuery& collisionLayer, IFireBulletCallback* fireBulletCallback)
-        : Entity(position, 3, 1000, "graphics/enemy", "right", fireBulletCallback)
+    Enemy(const sf::Vector2f& position, Player& player, TiledLayerSpatialQuery& collisionLayer, const sf::View& simulationView,
+          IFireBulletCallback* fireBulletCallback)
+        : Entity(position, 3, 1000, "graphics/enemy", Facing::RIGHT, fireBulletCallback)
         , mPlayer(player)
+        , mCollisionLayer(collisionLayer)
+        , mSimulationView(simulationView)
     {
+        // Stand on the overlapping collider that penetrates least. Merged colliders reach up whole wall
+        // columns, so the first or last one found can be many tiles above the floor
         mHitbox = GetGlobalBounds();
-        for (const GameObject& obj : collisionLayer.QueryRegion(mHitbox))
+        std::optional<float> groundTop;
+        for (const FloatRect& colliderBounds : collisionLayer.QueryColliders(mHitbox))
         {
-            mHitbox.SetBottom(obj.GetHitbox().GetTop());
+            if (!groundTop || colliderBounds.GetTop() > *groundTop)
+            {
+                groundTop = colliderBounds.GetTop();
+            }
+        }
+        if (groundTop)
+        {
+            mHitbox.SetBottom(*groundTop);
         }
         mPreviousHitbox = mHitbox;
         SetPosition({ std::round(mHitbox.GetLeft()), std::round(mHitbox.GetTop()) });
@@ -37,14 +60,24 @@ public:
     {
         if (mPlayer.GetHitbox().GetCenterX() < mHitbox.GetCenterX())
         {
-            SetStatus("left");
+            SetFacing(Facing::LEFT);
         }
         else
         {
-            SetStatus("right");
+            SetFacing(Facing::RIGHT);
         }  
     }
 
+    // Bullets fly horizontally from the muzzle, so the shot is clear when nothing solid lies
+    // between the muzzle and the player's center column at muzzle height
+    bool HasLineOfFire() const
+    {
+        sf::Vector2f muzzlePosition = GetBulletSpawnPosition(mHitbox, BULLET_SPAWN_OFFSET);
+        sf::Vector2f target(mPlayer.GetHitbox().GetCenterX(), muzzlePosition.y);
+        return !mCollisionLayer.IsSegmentBlocked(mHitbox.GetCenter(), muzzlePosition) &&
+               !mCollisionLayer.IsSegmentBlocked(muzzlePosition, target);
+    }
+
     void CheckFire()
     {
         float distance = (mHitbox.GetCenter() - mPlayer.GetHitbox().GetCenter()).length();
@@ -52,21 +85,32 @@ public:
         float playerCenterY = mPlayer.GetHitbox().GetCenterY();
         bool sameY = (mHitbox.GetTop() - 20 < playerCenterY && playerCenterY < mHitbox.GetBottom() + 20);
 
-        if (distance < 600.0f && CanFireBullet() && sameY)
+        if (distance < 600.0f && CanFireBullet() && sameY && HasLineOfFire())
         {
-            FireBullet(mHitbox, 40.0f, false);
+            FireBullet(mHitbox, BULLET_SPAWN_OFFSET, false);
             PlayShootSound();
         }
     }
 
+    // Timers and death run every tick whatever the LOD so cooldowns and health stay exact. Animation
+    // and AI are skipped while dormant and batched while near, the skipped time is handed to the
+    // animation once it runs again so it resumes where it would have been
     virtual void Update(const sf::Time& timeslice)
     {
         mPreviousHitbox = mHitbox;
-        UpdateStatus();
-        Animate(timeslice);
         UpdateTimerCooldowns(timeslice);
-        CheckFire();
-        Blink();
+
+        SimulationLod lod = ClassifySimulationLod(mHitbox.GetCenter(), mSimulationView, ACTIVE_LOD_MARGIN, NEAR_LOD_MARGIN);
+        mPendingTimeslice += timeslice;
+        if (lod == SimulationLod::ACTIVE || (lod == SimulationLod::NEAR && mPendingTimeslice.asSeconds() >= NEAR_LOD_INTERVAL))
+        {
+            UpdateStatus();
+            Animate(mPendingTimeslice);
+            CheckFire();
+            Blink();
+            mPendingTimeslice = sf::Time::Zero;
+        }
+
         CheckDeath();
     };
 
@@ -74,4 +118,7 @@ private:
     FloatRect mHitbox;
     FloatRect mPreviousHitbox;
     Player& mPlayer;
+    const TiledLayerSpatialQuery& mCollisionLayer;
+    const sf::View& mSimulationView;
+    sf::Time mPendingTimeslice;
 };
\ No newline at end of file
@@ -9,15 +9,18 @@
 // Core
 #include "Core/GameObject.h"
 #include "Core/Animate.h"
-#include "Core/StringUtils.h"
 #include "Core/Timer.h"
 #include "Core/Resources.h"
+#include "Core/JobSystem.h"
+#include "Core/RenderQueue.h"
 
 // Third party
 #include <SFML/Graphics.hpp>
 
 // System
 #include <filesystem>
+#include <optional>
+#include <stdexcept>
 
 namespace fs = std::filesystem;
 
@@ -35,14 +38,36 @@ std::vector<std::string> GetDirectoryNames(const std::string& path)
     return directories;
 }
 
+//------------------------------------------------------------------------------
+enum class Facing : uint8_t
+{
+    LEFT,
+    RIGHT,
+    COUNT
+};
+
+//------------------------------------------------------------------------------
+enum class EntityAction : uint8_t
+{
+    MOVE,
+    IDLE,
+    JUMP,
+    DUCK,
+    COUNT
+};
+
 //------------------------------------------------------------------------------
 class Entity : public GameObject
 {
+    static constexpr size_t FACING_COUNT = static_cast<size_t>(Facing::COUNT);
+    static constexpr size_t ACTION_COUNT = static_cast<size_t>(EntityAction::COUNT);
+
 public:
     Entity(const sf::Vector2f& position, int32_t health, int32_t firsCooldownTimeMsc, const std::string& animTextureDirectory, 
-           const std::string& status, IFireBulletCallback* fireBulletCallback)
+           Facing facing, IFireBulletCallback* fireBulletCallback)
         : mSprite(LoadTexture(Resources::PlaceholderTexture))
-        , mStatus(status)
+        , mFacing(facing)
+        , mAction(EntityAction::MOVE)
         , mHealth(health)
         , mBulletFireCooldown(sf::milliseconds(firsCooldownTimeMsc))
         , mFireBulletCallback(fireBulletCallback)
@@ -54,8 +79,8 @@ public:
         mBulletFireCooldown.Finish();
         mVolnerabilityTimer.Finish();
 
-        ImportAssets(animTextureDirectory, status);
-        mSprite.setTexture(mAnimation.GetTexture(), true);
+        ImportAssets(animTextureDirectory);
+        ApplyAnimationFrame();
         SetPosition(position);
     }
 
@@ -64,9 +89,22 @@ public:
         return mDepth;
     }
 
-    virtual FloatRect GetGlobalBounds() const override
+    // Opaque pixels of the current frame, trimmed at load time - unlike the hitbox it ignores sprite padding
+    virtual FloatRect GetHurtbox() const override
     {
-        return GetTransform().transformRect(mSprite.getLocalBounds());
+        return GetTransform().transformRect(sf::FloatRect(GetCollisionMask().GetOpaqueBounds()));
+    }
+
+    bool IsHurtboxOverlapping(const FloatRect& region) const
+    {
+        for (const sf::IntRect& subBounds : GetCollisionMask().GetOpaqueSubBounds())
+        {
+            if (region.FindIntersection(GetTransform().transformRect(sf::FloatRect(subBounds))))
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
     virtual void draw(sf::RenderTarget& target, const sf::RenderStates& states) const
@@ -76,11 +114,29 @@ public:
         target.draw(mSprite, statesCopy);
     }
 
+    virtual void SubmitDraw(RenderQueue& renderQueue) const override
+    {
+        renderQueue.Submit(GetDepth(), mSprite, GetTransform());
+    }
+
     void Animate(const sf::Time& timeslice)
     {
-        mAnimation.SetSequence(mStatus);
+        mAnimation.SetSequence(GetStateSequence());
         mAnimation.Update(timeslice);
-        mSprite.setTexture(mAnimation.GetTexture(), true);
+        ApplyAnimationFrame();
+    }
+
+    // Most ticks land on the same frame, so the sprite is only touched when the frame changes
+    void ApplyAnimationFrame()
+    {
+        const AtlasRegion& region = mAnimation.GetRegion();
+        if (&region != mAppliedRegion)
+        {
+            mSprite.setTexture(*region.mTexture);
+            mSprite.setTextureRect(region.mTextureRect);
+            SetLocalBounds(mSprite.getLocalBounds());
+            mAppliedRegion = &region;
+        }
     }
 
     void UpdateTimerCooldowns(const sf::Time& timeslice)
@@ -89,22 +145,31 @@ public:
         mVolnerabilityTimer.Update(timeslice);
     }
 
-    void FireBullet(const FloatRect& hotbox, float hortOffset, bool isPlayerBullet)
+    sf::Vector2f GetFireDirection() const
     {
         sf::Vector2f direction(-1.0f, 0.0f);
-        if (SplitAndGetElement(mStatus, '_', 0) == "right")
+        if (mFacing == Facing::RIGHT)
         {
             direction.x = 1.0f;
         }
-        sf::Vector2f position = hotbox.GetCenter() + direction * hortOffset;
+        return direction;
+    }
+
+    sf::Vector2f GetBulletSpawnPosition(const FloatRect& hotbox, float hortOffset) const
+    {
+        sf::Vector2f position = hotbox.GetCenter() + GetFireDirection() * hortOffset;
 
         sf::Vector2f yOffset(0.0f, -16.0f);
         if (IsDucking())
         {
             yOffset.y = 10.0f;
         }
+        return position + yOffset;
+    }
 
-        mFireBulletCallback->FireBullet(position + yOffset, direction, *this, isPlayerBullet);
+    void FireBullet(const FloatRect& hotbox, float hortOffset, bool isPlayerBullet)
+    {
+        mFireBulletCallback->FireBullet(GetBulletSpawnPosition(hotbox, hortOffset), GetFireDirection(), *this, isPlayerBullet);
         mBulletFireCooldown.Reset(true);
     }
 
@@ -113,15 +178,13 @@ public:
         return mBulletFireCooldown.IsFinished();
     }
 
-    const std::string& GetStatus()
-    {
-        return mStatus;
-    }
+    Facing GetFacing() const { return mFacing; }
 
-    void SetStatus(const std::string& value)
-    {
-        mStatus = value;
-    }
+    void SetFacing(Facing facing) { mFacing = facing; }
+
+    EntityAction GetAction() const { return mAction; }
+
+    void SetAction(EntityAction action) { mAction = action; }
 
     void Demage()
     {
@@ -160,24 +223,67 @@ public:
 
     uint32_t GetHealth() { return mHealth; }
 
-    void PlayShootSound() { mShootSound.play(); }
+    void PlayShootSound() 
+    { 
+        if (JobSystem::IsInParallelFor())
+        {
+            JobSystem::Defer([this]() { mShootSound.play(); });
+            return;
+        }
+        mShootSound.play(); 
+    }
 
     const sf::Sprite& GetSprite() { return mSprite; }
 
+    const CollisionMask& GetCollisionMask() const { return mAnimation.GetCollisionMask(); }
+
 private:
-    void ImportAssets(const std::string& animTextureDirectory, const std::string& animaSequenceId)
+    // Sequence directories are named <facing>[_<action>], e.g. "left" or "right_duck"
+    void ImportAssets(const std::string& animTextureDirectory)
     {
         for (const std::string& directoryName : GetDirectoryNames(RESOURCES_PATH + animTextureDirectory))
         {
             std::string relativeDirectory = animTextureDirectory + "/" + directoryName + "/";
-            mAnimation.AddSequence({ directoryName, LoadTexuresFromDirectory(relativeDirectory) });
+            mAnimation.AddSequence({ directoryName, LoadAtlasRegionsFromDirectory(relativeDirectory) });
         }
-        mAnimation.SetSequence(animaSequenceId);
+        ResolveStateSequences();
+        mAnimation.SetSequence(GetStateSequence());
+    }
+
+    // Resolve every facing/action pair to a sequence index once, so animating never touches strings.
+    // Actions without their own directory fall back to the facing's move sequence
+    void ResolveStateSequences()
+    {
+        static const char* FACING_NAMES[FACING_COUNT] = { "left", "right" };
+        static const char* ACTION_SUFFIXES[ACTION_COUNT] = { "", "_idle", "_jump", "_duck" };
+
+        for (size_t facing = 0; facing < FACING_COUNT; facing++)
+        {
+            std::optional<uint32_t> moveSequence = mAnimation.FindSequence(FACING_NAMES[facing]);
+            if (!moveSequence)
+            {
+                throw std::runtime_error(std::string("Missing animation sequence: ") + FACING_NAMES[facing]);
+            }
+
+            for (size_t action = 0; action < ACTION_COUNT; action++)
+            {
+                std::optional<uint32_t> sequence = mAnimation.FindSequence(std::string(FACING_NAMES[facing]) + ACTION_SUFFIXES[action]);
+                mStateSequences[facing][action] = sequence.value_or(*moveSequence);
+            }
+        }
+    }
+
+    uint32_t GetStateSequence() const
+    {
+        return mStateSequences[static_cast<size_t>(mFacing)][static_cast<size_t>(mAction)];
     }
 
     Animation mAnimation;
     sf::Sprite mSprite;
-    std::string mStatus;
+    const AtlasRegion* mAppliedRegion = nullptr;
+    uint32_t mStateSequences[FACING_COUNT][ACTION_COUNT];
+    Facing mFacing;
+    EntityAction mAction;
     Timer mBulletFireCooldown;
     Timer mVolnerabilityTimer;
     IFireBulletCallback* mFireBulletCallback;
@@ -17,15 +17,30 @@
 #include "Core/GameObjectManager.h"
 #include "Core/Resources.h"
 #include "Core/SpriteComparisonUtils.h"
+#include "Core/SpatialHash.h"
+#include "Core/SweepUtils.h"
+#include "Core/FrameArena.h"
+#include "Core/AllocationTracker.h"
+#include "Core/EventQueue.h"
+#include "Core/UpdateScheduler.h"
+#include "Core/JobSystem.h"
+#include "Core/TextureAtlas.h"
+#include "Core/RenderQueue.h"
+#include "Core/DrawBuckets.h"
 
 //------------------------------------------------------------------------------
 class Overlay
 {
 public:
-    Overlay(Player& player)
+    Overlay(Player& player, const RenderQueue& renderQueue)
         : mPlayer(player)
+        , mRenderQueue(renderQueue)
         , mHealthPoint(LoadTexture(Resources::HealthPoint))
-    { }
+        , mAllocationText(LoadFont(Resources::Font), "", 14)
+        , mRenderStatsText(LoadFont(Resources::Font), "", 14)
+    { 
+        mAllocationText.setPosition({ 10.0f, 40.0f });
+    }
 
     void Draw(sf::RenderWindow& window)
     {     
@@ -37,11 +52,48 @@ public:
             mHealthPoint.setPosition({ x, y });
             window.draw(mHealthPoint);
         }
+
+        if (AllocationTracker::IsEnabled())
+        {
+            DrawAllocationStats(window);
+        }
+
+#if !PRODUCTION_BUILD
+        DrawRenderStats(window);
+#endif
     }
 
 private:
+    void DrawAllocationStats(sf::RenderWindow& window)
+    {
+        AllocationStats frameStats = AllocationTracker::GetLastFrameStats();
+        std::string text = "Allocations per frame: " + std::to_string(frameStats.mCount) + " (" + std::to_string(frameStats.mBytes) + " bytes)";
+        for (uint32_t index = 0; index < AllocationTracker::GetZoneCount(); index++)
+        {
+            const AllocationZoneStats& zone = AllocationTracker::GetZoneStats(index);
+            text += "\n  " + std::string(zone.mName) + ": " + std::to_string(zone.mLastFrame.mCount) + " (" + std::to_string(zone.mLastFrame.mBytes) + " bytes)";
+        }
+
+        // Should stop climbing once the first few ticks have sized the event storage
+        text += "\nEvent queue growths: " + std::to_string(EventQueue::Instance()->GetAllocationCount());
+
+        mAllocationText.setString(text);
+        window.draw(mAllocationText);
+    }
+
+    void DrawRenderStats(sf::RenderWindow& window)
+    {
+        const RenderQueue::Stats& stats = mRenderQueue.GetStats();
+        mRenderStatsText.setString("Sprites: " + std::to_string(stats.mQuadCount) + "  Draw calls: " + std::to_string(stats.mDrawCallCount));
+        mRenderStatsText.setPosition({ window.getView().getSize().x - mRenderStatsText.getLocalBounds().width - 10.0f, 10.0f });
+        window.draw(mRenderStatsText);
+    }
+
     Player& mPlayer;
+    const RenderQueue& mRenderQueue;
     sf::Sprite mHealthPoint;
+    sf::Text mAllocationText;
+    sf::Text mRenderStatsText;
 };
 
 //------------------------------------------------------------------------------
@@ -67,8 +119,13 @@ public:
     // Layer management    
     LayerStack& GetLayerStack() { return mLayerStack; }
 
+    // Allocation tracking builds assert when Update touches the heap, for layers expected to be steady
+    void SetAssertNoAllocationsInUpdate(bool enabled) { mAssertNoAllocationsInUpdate = enabled; }
+    bool IsAssertingNoAllocationsInUpdate() const { return mAssertNoAllocationsInUpdate; }
+
 private:
     LayerStack& mLayerStack;
+    bool mAssertNoAllocationsInUpdate = false;
 };
 
 //------------------------------------------------------------------------------
@@ -119,6 +176,7 @@ public:
     {
         for (size_t i = mLayers.size(); i-- > 0; )
         {
+            AllocationZone zone("Update", mLayers[i]->IsAssertingNoAllocationsInUpdate());
             if (!mLayers[i]->Update(timeslice)) 
             {
                 break;
@@ -128,6 +186,7 @@ public:
 
     void Draw(sf::RenderWindow& window) 
     {
+        AllocationZone zone("Draw");
         for (size_t i = 0; i < mLayers.size(); ++i) 
         {
             if (!mLayers[i]->Draw(window)) {
@@ -273,6 +332,13 @@ private:
 //------------------------------------------------------------------------------
 class Game : public Layer, public IGame, public IFireBulletCallback
 {
+    // Pre updates run before the collision indices are rebuilt and the player moves, post updates after
+    enum class UpdatePhase : uint32_t
+    {
+        PRE_UPDATE,
+        POST_UPDATE
+    };
+
 public:
     Game(LayerStack& layerStack, GameObjectManager& manager, const sf::Vector2u& windowSize)
         : Layer(layerStack)
@@ -281,7 +347,12 @@ public:
         , mPlayer{ nullptr }
         , mMusic(LoadMusic(Resources::Music))
     {         
-        mLayerRenderer = std::make_unique<TiledMapLayerRenderer>(mTiledMap, windowSize);
+        mUpdateScheduler.RegisterType<Enemy>(UpdatePhase::PRE_UPDATE, UpdateMode::PARALLEL);
+        mUpdateScheduler.RegisterType<MovingPlatform>(UpdatePhase::PRE_UPDATE, UpdateMode::PARALLEL);
+        mUpdateScheduler.RegisterType<Bullet>(UpdatePhase::POST_UPDATE, UpdateMode::PARALLEL);
+        mUpdateScheduler.RegisterType<FireAnimation>(UpdatePhase::POST_UPDATE, UpdateMode::PARALLEL);
+
+        mLayerRenderer = std::make_unique<TiledMapLayerRenderer>(mTiledMap);
         mLayerRenderer->EnablAllLayersForRender();
 
         mMusic.play();
@@ -299,6 +370,9 @@ public:
         mBackground.AddLayer(std::move(foregroundLayer));
         mBackground.AddLayer(std::move(backgroundLayer));
 
+        // Packing builds the collision masks of every sprite frame, including the bullet's
+        BuildTextureAtlas({ std::begin(Resources::AtlasSources), std::end(Resources::AtlasSources) });
+
         PopulateScene(windowSize);
     }
 
@@ -315,17 +389,17 @@ public:
             if (object.getName() == "Player")
             {
                 mPlayerStartposition = ConvertToSFMLVector2f(object.getPosition());
-                mPlayer = mManager.CreateGameObject<Player>(mPlayerStartposition, *mCollisionLayer, mCollisionObjects, this);
-                mDrawGroup.AddGameObject(mPlayer);
+                mPlayer = mManager.CreateGameObject<Player>(mPlayerStartposition, *mCollisionLayer, mCollisionObjectIndex, this);
+                mDrawBuckets.AddGameObject(mPlayer);
                 mGameView.setCenter(mPlayerStartposition);
             }
             else if (object.getName() == "Enemy")
             {
                 sf::Vector2f position = ConvertToSFMLVector2f(object.getPosition());
-                Enemy* enemy = mManager.CreateGameObject<Enemy>(position, *mPlayer, *mCollisionLayer, this);
-                mDrawGroup.AddGameObject(enemy);
+                Enemy* enemy = mManager.CreateGameObject<Enemy>(position, *mPlayer, *mCollisionLayer, mGameView, this);
+                mDrawBuckets.AddGameObject(enemy);
                 mVulnerableObjects.AddGameObject(enemy);
-                mPreUpdateGroup.AddGameObject(enemy);
+                mUpdateScheduler.AddGameObject(enemy);
             }
         }
 
@@ -338,9 +412,9 @@ public:
                 position.y -= textureRegion.height; // Tiled map object origin is bottom left
 
                 auto platform = mManager.CreateGameObject<MovingPlatform>(position, *texture, textureRegion, mPlatformWayPoints);
-                mDrawGroup.AddGameObject(platform);
+                mDrawBuckets.AddGameObject(platform);
                 mCollisionObjects.AddGameObject(platform);
-                mPreUpdateGroup.AddGameObject(platform);
+                mUpdateScheduler.AddGameObject(platform);
             }
             else if (object.getName() == "Border")
             {
@@ -350,17 +424,41 @@ public:
             }
         }
 
-        mOverlay = std::make_unique<Overlay>(*mPlayer);
+        mOverlay = std::make_unique<Overlay>(*mPlayer, mRenderQueue);
     }
 
     virtual void ResetScene() override
     {
-        GameObjectManager::Instance().RemoveAllGameObjects();
+        ClearScene();
         PopulateScene(sf::Vector2u(mGameView.getSize()));
     }
 
+    // Drops the whole scene at once, groups forget their members instead of each object being killed
+    void ClearScene()
+    {
+        for (Group* group : { &mPlayerBulletObjects, &mEnemyBulletObjects, &mBulletObjects, &mCollisionObjects,
+                              &mVulnerableObjects })
+        {
+            group->Clear();
+        }
+        mDrawBuckets.Clear();
+        mUpdateScheduler.Clear();
+        mCollisionObjectIndex.Clear();
+        mVulnerableObjectIndex.Clear();
+        mPlatformWayPoints.clear();
+        mPlayer = nullptr;
+
+        mManager.ClearScene();
+    }
+
     virtual void FireBullet(const sf::Vector2f& position, const sf::Vector2f& direction, Entity& entity, bool isPlayerBullet) override
     {        
+        if (JobSystem::IsInParallelFor())
+        {
+            JobSystem::Defer([this, position, direction, &entity, isPlayerBullet]() { FireBullet(position, direction, entity, isPlayerBullet); });
+            return;
+        }
+
         sf::Color tintColor = sf::Color::White;
         if (isPlayerBullet)
         {
@@ -368,13 +466,13 @@ public:
         }
 
         auto bullet = mManager.CreateGameObject<Bullet>(position, direction, tintColor);
-        mDrawGroup.AddGameObject(bullet);        
-        mPostUpdateGroup.AddGameObject(bullet);
+        mDrawBuckets.AddGameObject(bullet);        
+        mUpdateScheduler.AddGameObject(bullet);
         mBulletObjects.AddGameObject(bullet);
 
-        auto fireAnimation = mManager.CreateGameObject<FireAnimation>(entity.GetEntityId(), direction, tintColor);
-        mDrawGroup.AddGameObject(fireAnimation);
-        mPostUpdateGroup.AddGameObject(fireAnimation);
+        auto fireAnimation = mManager.CreateGameObject<FireAnimation>(entity.GetEntityHandle(), direction, tintColor);
+        mDrawBuckets.AddGameObject(fireAnimation);
+        mUpdateScheduler.AddGameObject(fireAnimation);
 
         if (isPlayerBullet)
         {
@@ -400,82 +498,144 @@ public:
         mGameView.setSize(size);      
     }
 
-    void BulletCollision()
+    // Earliest time of impact along the bullet's path this tick against level tiles and platforms, 
+    // platforms are swept in the bullet's frame of reference so their own motion is accounted for
+    std::optional<float> SweepBulletAgainstSolids(const Bullet& bullet)
     {
-        // Enevironment collision
-        for (GameObject* bullet : mBulletObjects)
+        FloatRect previousHitbox = bullet.GetPreviousHitbox();
+        sf::Vector2f displacement = GetHitboxDisplacement(previousHitbox, bullet.GetHitbox());
+
+        std::optional<float> timeOfImpact = mCollisionLayer->SweepColliders(previousHitbox, displacement);
+        for (const SpatialHash::Proxy* obstacle : mCollisionObjectIndex.Query(GetSweptBounds(previousHitbox, displacement)))
         {
-            for (const GameObject& obj : mCollisionLayer->QueryRegion(bullet->GetHitbox()))
+            const FloatRect& obstaclePreviousHitbox = obstacle->mPreviousBounds;
+            sf::Vector2f relativeDisplacement = displacement - GetHitboxDisplacement(obstaclePreviousHitbox, obstacle->mBounds);
+
+            std::optional<float> obstacleTimeOfImpact = SweepRect(previousHitbox, relativeDisplacement, obstaclePreviousHitbox);
+            if (obstacleTimeOfImpact && (!timeOfImpact || *obstacleTimeOfImpact < *timeOfImpact))
             {
-                bullet->Kill();
-                break;
+                timeOfImpact = obstacleTimeOfImpact;
             }
         }
+        return timeOfImpact;
+    }
+
+    // Earliest pixel perfect hit of the bullet's path on the entity up to maxTimeOfImpact. The path is
+    // marched from the first hurtbox contact in steps of half the bullet's smaller side, so no
+    // opaque overlap is stepped over however far the bullet travels in one tick
+    std::optional<float> FindBulletHit(const Bullet& bullet, const Entity& entity, float maxTimeOfImpact)
+    {
+        FloatRect previousHitbox = bullet.GetPreviousHitbox();
+        sf::Vector2f displacement = GetHitboxDisplacement(previousHitbox, bullet.GetHitbox());
 
-        for (GameObject* bullet : mBulletObjects)
+        std::optional<float> entryTime = SweepRect(previousHitbox, displacement, entity.GetHurtbox());
+        if (!entryTime || *entryTime > maxTimeOfImpact)
         {
-            for (GameObject* obstacle : mCollisionObjects)
+            return std::nullopt;
+        }
+
+        float stepLength = std::max(std::min(previousHitbox.GetWidth(), previousHitbox.GetHeight()) / 2.0f, 1.0f);
+        float pathLength = displacement.length();
+        float timeStep = pathLength > stepLength ? stepLength / pathLength : 1.0f;
+
+        sf::Transformable sampleTransformable = bullet.GetInternaleTransformable();
+        sf::Vector2f previousPosition = bullet.GetPosition() - displacement;
+        for (float time = *entryTime; ; time += timeStep)
+        {
+            time = std::min(time, maxTimeOfImpact);
+
+            FloatRect sampleHitbox = previousHitbox;
+            sampleHitbox.MoveLeft(displacement.x * time);
+            sampleHitbox.MoveTop(displacement.y * time);
+            sampleTransformable.setPosition(previousPosition + displacement * time);
+
+            if (entity.IsHurtboxOverlapping(sampleHitbox) &&
+                BitmaskCompare(bullet.GetCollisionMask(), sampleTransformable,
+                               entity.GetCollisionMask(), entity.GetInternaleTransformable()))
             {
-                if (bullet->GetHitbox().FindIntersection(obstacle->GetHitbox()))
-                {                                        
-                    bullet->Kill();
-                    break;
-                }
+                return time;
+            }
+
+            if (time >= maxTimeOfImpact)
+            {
+                return std::nullopt;
             }
         }
+    }
 
+    // Bullets are resolved against the whole path they covered this tick, so hits do not depend on
+    // the tick rate - whatever the bullet reaches first along the path stops it
+    void BulletCollision()
+    {
         // Enemy hit by bullet
-        for (GameObject* bullet : mPlayerBulletObjects)
+        for (GameObject* object : mPlayerBulletObjects)
         {
-            for (GameObject* obstacle : mVulnerableObjects)
+            Bullet* bullet = static_cast<Bullet*>(object);
+            std::optional<float> solidTimeOfImpact = SweepBulletAgainstSolids(*bullet);
+            float maxTimeOfImpact = solidTimeOfImpact.value_or(1.0f);
+
+            Entity* hitEntity = nullptr;
+            FloatRect sweptBounds = GetSweptBounds(bullet->GetPreviousHitbox(), bullet->GetHitbox());
+            for (const SpatialHash::Proxy* vulnerable : mVulnerableObjectIndex.Query(sweptBounds))
             {
-                if (bullet->GetHitbox().FindIntersection(obstacle->GetHitbox()))
+                Entity* entity = static_cast<Entity*>(vulnerable->mObject);
+                if (std::optional<float> hitTime = FindBulletHit(*bullet, *entity, maxTimeOfImpact))
                 {
-                    if (BitmaskCompare(static_cast<Bullet*>(bullet)->GetSprite(),
-                                       bullet->GetInternaleTransformable(),
-                                       static_cast<Entity*>(obstacle)->GetSprite(),
-                                       obstacle->GetInternaleTransformable()))
-                    {
-                        bullet->Kill();
-                        static_cast<Entity*>(obstacle)->Demage();
-                    }
+                    hitEntity = entity;
+                    maxTimeOfImpact = *hitTime;
                 }
             }
+
+            if (hitEntity)
+            {
+                bullet->Kill();
+                hitEntity->Demage();
+            }
+            else if (solidTimeOfImpact)
+            {
+                bullet->Kill();
+            }
         }
 
         // Player hit by bullet
-        for (GameObject* bullet : mEnemyBulletObjects)
-        {         
-            if (mPlayer->GetHitbox().FindIntersection(bullet->GetHitbox()))
-            {                
-                if (BitmaskCompare(static_cast<Bullet*>(bullet)->GetSprite(),
-                                   bullet->GetInternaleTransformable(),
-                                   mPlayer->GetSprite(),
-                                   mPlayer->GetInternaleTransformable()))
-                {
-                    bullet->Kill();
-                    mPlayer->Demage();
-                    break;
-                }                                
+        FloatRect playerHurtbox = mPlayer->GetHurtbox();
+        bool isPlayerHit = false;
+        for (GameObject* object : mEnemyBulletObjects)
+        {
+            Bullet* bullet = static_cast<Bullet*>(object);
+            std::optional<float> solidTimeOfImpact = SweepBulletAgainstSolids(*bullet);
+
+            FloatRect sweptBounds = GetSweptBounds(bullet->GetPreviousHitbox(), bullet->GetHitbox());
+            if (!isPlayerHit && sweptBounds.FindIntersection(playerHurtbox) && 
+                FindBulletHit(*bullet, *mPlayer, solidTimeOfImpact.value_or(1.0f)))
+            {
+                isPlayerHit = true;
+                bullet->Kill();
+                mPlayer->Demage();
+            }
+            else if (solidTimeOfImpact)
+            {
+                bullet->Kill();
             }
         }
     }
 
     virtual bool Update(const sf::Time& timeslice) override
     {   
-        for (GameObject* object : mPreUpdateGroup)
-        {
-            object->Update(timeslice);
-        }
+        mUpdateScheduler.Update(UpdatePhase::PRE_UPDATE, timeslice);
+
+        // Platforms and enemies are done moving for this tick
+        mCollisionObjectIndex.Rebuild(mCollisionObjects, &GameObject::GetHitbox, &GameObject::GetPreviousHitbox);
+        mVulnerableObjectIndex.Rebuild(mVulnerableObjects, &GameObject::GetHurtbox);
 
         mPlayer->Update(timeslice);
 
-        for (GameObject* object : mPostUpdateGroup)
+        mUpdateScheduler.Update(UpdatePhase::POST_UPDATE, timeslice);
+
         {
-            object->Update(timeslice);
+            AllocationZone zone("BulletCollision");
+            BulletCollision();
         }
-
-        BulletCollision();
                 
         if (mPlayer->GetPosition().y > MAX_LEVEL_HEIGHT)
         {                        
@@ -497,21 +657,20 @@ public:
     {
         window.setView(mGameView);               
         
-        mBackground.Draw(window, ComputeVisibleRegion());
+        sf::FloatRect visibleRegion = ComputeVisibleRegion();
+        mBackground.Draw(window, visibleRegion);
+
+        TiledMapVisibleRegion tiledMapVisibleRegion(visibleRegion, mTiledMap.GetTileSize());
 
-        TiledMapVisibleRegion tiledMapVisibleRegion(ComputeVisibleRegion(), mTiledMap.GetTileSize());
+        // Visible sprites are batched up front, each tile layer is then followed by the batches at its depth
+        mRenderQueue.Clear();
+        mDrawBuckets.Submit(mRenderQueue, visibleRegion);
+        mRenderQueue.Sort();
 
         for (uint32_t index = 0; index < mTiledMap.LayerCount(); index++)
         {
             mLayerRenderer->DrawLayer(window, index, tiledMapVisibleRegion);
-
-            for (const GameObject* obj : mDrawGroup)
-            {                                
-                if (obj->GetDepth() == index)
-                {
-                    window.draw(*obj);                
-                }
-            }
+            mRenderQueue.Draw(window, index);
         }
 
         window.setView(mHUDView);
@@ -524,7 +683,7 @@ public:
     virtual void OnExit() 
     { 
         mMusic.stop(); 
-        GameObjectManager::Instance().RemoveAllGameObjects();
+        ClearScene();
     }
 
 private:
@@ -542,9 +701,11 @@ private:
     Group mBulletObjects;
     Group mCollisionObjects;
     Group mVulnerableObjects;
-    Group mDrawGroup;
-    Group mPreUpdateGroup;
-    Group mPostUpdateGroup;
+    DrawBuckets mDrawBuckets;
+    RenderQueue mRenderQueue;
+    UpdateScheduler mUpdateScheduler;
+    SpatialHash mCollisionObjectIndex;
+    SpatialHash mVulnerableObjectIndex;
     sf::Vector2f mPlayerStartposition;
     TiledMap mTiledMap;
     std::unique_ptr<TiledMapLayerRenderer> mLayerRenderer;
@@ -559,13 +720,16 @@ private:
 //------------------------------------------------------------------------------
 int main()
 {
+    // Job system workers register themselves, the main thread lives as long as the process
+    AllocationTracker::RegisterThread();
+
     GameObjectManager& manager = GameObjectManager::Instance();
     
     sf::RenderWindow window(sf::VideoMode(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), "Run-And-Gun");
     window.setVerticalSyncEnabled(true);
     
     sf::Clock clock;
-    const sf::Time timePerFrame = sf::seconds(1.0f / 60.0f);
+    const sf::Time timePerFrame = sf::seconds(1.0f / SIMULATION_TICK_RATE);
     sf::Time timeSinceLastUpdate = sf::Time::Zero;
 
     LayerStack layerStack;
@@ -595,8 +759,13 @@ int main()
         while (timeSinceLastUpdate >= timePerFrame)
         {
             timeSinceLastUpdate -= timePerFrame;            
+            ResetFrameArena();
+            AllocationTracker::BeginFrame();
             layerStack.Update(timePerFrame);
-            manager.SyncGameObjectChanges();
+            {
+                AllocationZone zone("SyncGameObjectChanges");
+                manager.SyncGameObjectChanges();
+            }
             
             window.clear({ 249, 131, 103 });
             layerStack.Draw(window);
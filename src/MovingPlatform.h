@@ -9,6 +9,7 @@
 #include <Core/GameObject.h>
 #include <Core/RectUtils.h>
 #include <Core/FloatRect.h>
+#include <Core/RenderQueue.h>
 
 // Third party
 #include <SFML/Graphics.hpp>
@@ -24,15 +25,11 @@ public:
         , mDepth(LAYERS.at("Level"))
         , mSpeed(200.0f)
     {
+        SetLocalBounds(mSprite.getLocalBounds());
         SetPosition(position);
         mHitbox = GetGlobalBounds();
     }
 
-    virtual FloatRect GetGlobalBounds() const override
-    {
-        return GetTransform().transformRect(mSprite.getLocalBounds());
-    }
-
     virtual FloatRect GetHitbox() const override
     {
         return mHitbox;
@@ -85,6 +82,11 @@ public:
         target.draw(mSprite, statesCopy);
     }
 
+    virtual void SubmitDraw(RenderQueue& renderQueue) const override
+    {
+        renderQueue.Submit(GetDepth(), mSprite, GetTransform());
+    }
+
 private:    
     bool IsMovingDown() const { return mDirection.y > 0.0f; }
     void ReverseDirection() { mDirection.y = -mDirection.y; }
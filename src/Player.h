@@ -7,13 +7,28 @@
 #include "TiledMap.h"
 #include "Settings.h"
 
+// Core
+#include "Core/SpatialHash.h"
+#include "Core/FrameArena.h"
+
+// System
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 class Player : public Entity
 {
+    // Level tiles carry no object and never move
+    struct CollisionContact
+    {
+        FloatRect mHitbox;
+        sf::Vector2f mVelocity;
+        const GameObject* mObject;
+    };
+
 public:
-    Player(const sf::Vector2f& position, TiledLayerSpatialQuery& collisionLayer, Group& collisionObjects, 
+    Player(const sf::Vector2f& position, TiledLayerSpatialQuery& collisionLayer, const SpatialHash& collisionObjects, 
           IFireBulletCallback* fireBulletCallback)
-        : Entity(position, 10, 200, "graphics/player", "right", fireBulletCallback)
+        : Entity(position, 10, 200, "graphics/player", Facing::RIGHT, fireBulletCallback)
         , mCollisionLayer(collisionLayer)
         , mCollisionObjects(collisionObjects)                   
         , mWalkSpeed(400.0f)
@@ -45,12 +60,14 @@ public:
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right))
         {
             mDirection.x = 1.0f;
-            SetStatus("right");
+            SetFacing(Facing::RIGHT);
+            SetAction(EntityAction::MOVE);
         }
         else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))
         {
             mDirection.x = -1.0f;
-            SetStatus("left");            
+            SetFacing(Facing::LEFT);
+            SetAction(EntityAction::MOVE);
         }
         else
         {
@@ -86,17 +103,17 @@ public:
     {
         if (mDirection.x == 0 && mIsOnFloor)
         {
-            SetStatus(SplitAndGetElement(GetStatus(), '_', 0) + "_idle");
+            SetAction(EntityAction::IDLE);
         }
 
         if (!mIsOnFloor)
         {
-            SetStatus(SplitAndGetElement(GetStatus(), '_', 0) + "_jump");
+            SetAction(EntityAction::JUMP);
         }
 
         if (mIsOnFloor && mIsDucking)
         {
-            SetStatus(SplitAndGetElement(GetStatus(), '_', 0) + "_duck");
+            SetAction(EntityAction::DUCK);
         }
     }
 
@@ -156,26 +173,34 @@ public:
 private:
     void CheckAndResolveHortCollision()
     {
-        // Level collisions
-        for (const GameObject& obj : mCollisionLayer.QueryRegion(mHitbox))
+        // Level collisions. Merged colliders can span many tiles, so only push out sideways when that is
+        // the shallower way out - deeper sideways overlap means floor or ceiling, left to the vertical pass
+        for (const FloatRect& colliderBounds : mCollisionLayer.QueryColliders(mHitbox))
         {
+            float vertPenetration = std::min(mHitbox.GetBottom() - colliderBounds.GetTop(), colliderBounds.GetBottom() - mHitbox.GetTop());
             if (mDirection.x > 0)
             {
-                mHitbox.SetRight(obj.GetHitbox().GetLeft());
+                if (mHitbox.GetRight() - colliderBounds.GetLeft() <= vertPenetration)
+                {
+                    mHitbox.SetRight(colliderBounds.GetLeft());
+                }
             }
             else if (mDirection.x < 0)
             {
-                mHitbox.SetLeft(obj.GetHitbox().GetRight());
+                if (colliderBounds.GetRight() - mHitbox.GetLeft() <= vertPenetration)
+                {
+                    mHitbox.SetLeft(colliderBounds.GetRight());
+                }
             }
         }
 
         // Obstacle collisions
-        for (GameObject* obj : mCollisionObjects)
+        for (const SpatialHash::Proxy* obj : mCollisionObjects.Query(mHitbox))
         {            
-            const FloatRect& objCntHitbox = obj->GetHitbox();
+            const FloatRect& objCntHitbox = obj->mBounds;
             if (objCntHitbox.FindIntersection(mHitbox))
             {
-                const FloatRect& objPrvHitbox = obj->GetPreviousHitbox();
+                const FloatRect& objPrvHitbox = obj->mPreviousBounds;
 
                 // Left
                 if (mHitbox.GetLeft() <= objCntHitbox.GetRight() && mPreviousHitbox.GetLeft() >= objPrvHitbox.GetRight())
@@ -195,88 +220,88 @@ private:
     void CheckAndResolveVertCollision()
     {
         mIsOnFloor = false;        
-        std::vector<const GameObject*> objectsBelow;
-        std::vector<const GameObject*> objectsAbove;
+        std::pmr::vector<CollisionContact> contactsBelow(&GetFrameArena());
+        std::pmr::vector<CollisionContact> contactsAbove(&GetFrameArena());
 
         // Process level collisions
-        for (const GameObject& object : mCollisionLayer.QueryRegion(mHitbox))
+        for (const FloatRect& colliderBounds : mCollisionLayer.QueryColliders(mHitbox))
         {
             if (mDirection.y > 0.0f)
             {
-                objectsBelow.emplace_back(&object);
+                contactsBelow.push_back({ colliderBounds, sf::Vector2f(), nullptr });
             }
             else if (mDirection.y < 0.0f)
             {
-                objectsAbove.emplace_back(&object);
+                contactsAbove.push_back({ colliderBounds, sf::Vector2f(), nullptr });
             }
         }
 
         // Process dynamic obstacle collisions
-        for (const GameObject* object : mCollisionObjects)
+        for (const SpatialHash::Proxy* object : mCollisionObjects.Query(mHitbox))
         {            
-            FloatRect objectHitbox = object->GetHitbox();
+            const FloatRect& objectHitbox = object->mBounds;
 
             if (objectHitbox.FindIntersection(mHitbox))
             {
-                if (IsDownCollision(*object))
+                if (IsDownCollision(mHitbox, mPreviousHitbox, objectHitbox, object->mPreviousBounds))
                 {
-                    objectsBelow.emplace_back(object);
+                    contactsBelow.push_back({ objectHitbox, object->mVelocity, object->mObject });
                 }
-                else if (IsUpCollision(*object))
+                else if (IsUpCollision(mHitbox, mPreviousHitbox, objectHitbox, object->mPreviousBounds))
                 {
-                    objectsAbove.emplace_back(object);
+                    contactsAbove.push_back({ objectHitbox, object->mVelocity, object->mObject });
                 }
             }
         }
 
-        ResolveVertCollision(objectsBelow, objectsAbove);
+        ResolveVertCollision(contactsBelow, contactsAbove);
     }
 
-    void ResolveVertCollision(std::vector<const GameObject*>& objectsBelow, std::vector<const GameObject*>& objectsAbove)
+    void ResolveVertCollision(std::pmr::vector<CollisionContact>& contactsBelow, std::pmr::vector<CollisionContact>& contactsAbove)
     {
-        // Resolve ground objects
-        const GameObject* lowestYVelocityoObject = nullptr;
-        for (const GameObject* object : objectsBelow)
+        // Resolve ground contacts
+        const CollisionContact* lowestYVelocityContact = nullptr;
+        for (const CollisionContact& contact : contactsBelow)
         {
-            if (!lowestYVelocityoObject || object->GetVelocity().y < lowestYVelocityoObject->GetVelocity().y)
+            if (!lowestYVelocityContact || contact.mVelocity.y < lowestYVelocityContact->mVelocity.y)
             {
-                lowestYVelocityoObject = object;
+                lowestYVelocityContact = &contact;
             }
         }
         
         mMovingTileUnderPlayer = nullptr;
-        if (lowestYVelocityoObject)
+        if (lowestYVelocityContact)
         {
-            mHitbox.SetBottom(lowestYVelocityoObject->GetHitbox().GetTop());
-            mDirection.y = lowestYVelocityoObject->GetVelocity().y;
+            mHitbox.SetBottom(lowestYVelocityContact->mHitbox.GetTop());
+            mDirection.y = lowestYVelocityContact->mVelocity.y;
             mIsOnFloor = true;     
             mIsJumping = false;
             if (mDirection.y != 0.0f)
             {
-                mMovingTileUnderPlayer = lowestYVelocityoObject;
+                mMovingTileUnderPlayer = lowestYVelocityContact->mObject;
             }
         }
 
-        // Resolve ceiling objects
-        const GameObject* highestYVelocityObject = nullptr;
-        for (const GameObject* object : objectsAbove)
+        // Resolve ceiling contacts
+        const CollisionContact* highestYVelocityContact = nullptr;
+        for (const CollisionContact& contact : contactsAbove)
         {
-            if (!highestYVelocityObject || object->GetVelocity().y > highestYVelocityObject->GetVelocity().y)
+            if (!highestYVelocityContact || contact.mVelocity.y > highestYVelocityContact->mVelocity.y)
             {
-                highestYVelocityObject = object;
+                highestYVelocityContact = &contact;
             }
         }
 
-        if (highestYVelocityObject)
+        if (highestYVelocityContact)
         {                 
-            mHitbox.SetTop(highestYVelocityObject->GetHitbox().GetBottom());
-            mDirection.y = highestYVelocityObject->GetVelocity().y;
+            mHitbox.SetTop(highestYVelocityContact->mHitbox.GetBottom());
+            mDirection.y = highestYVelocityContact->mVelocity.y;
         }
     }
     
     const GameObject* mMovingTileUnderPlayer = nullptr;
     TiledLayerSpatialQuery& mCollisionLayer;
-    Group& mCollisionObjects;    
+    const SpatialHash& mCollisionObjects;    
     sf::Vector2f mDirection;
     FloatRect mHitbox;
     FloatRect mPreviousHitbox;
@@ -11,6 +11,9 @@ constexpr uint32_t WINDOW_WIDTH = 1280;
 constexpr uint32_t WINDOW_HEIGHT = 720;
 constexpr uint32_t MAX_LEVEL_HEIGHT = 3500;
 
+// Bullets are swept along their whole path each tick, so lowering this does not let them tunnel
+constexpr float SIMULATION_TICK_RATE = 60.0f;
+
 const extern std::unordered_map<std::string, uint32_t> LAYERS;
 
 namespace Resources{
@@ -27,4 +30,7 @@ namespace Resources{
     constexpr char HitSound[] = "audio/hit.wav";
     constexpr char ShootSound[] = "audio/bullet.wav";
     constexpr char Font[] = "fonts/subatomic.ttf";
+
+    // Sprite frames packed into the texture atlas at startup, directories are searched recursively
+    constexpr const char* AtlasSources[] = { "graphics/player", "graphics/enemy", "graphics/fire", BulletTexture };
 }
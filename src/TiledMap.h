@@ -5,7 +5,8 @@
 // Core
 #include "Core/Resources.h"
 #include "Core/DrawUtils.h"
-#include "Core/GameObject.h"
+#include "Core/FloatRect.h"
+#include "Core/SweepUtils.h"
 
 // Third party
 #include <SFML/Graphics.hpp>
@@ -13,6 +14,11 @@
 
 // System 
 #include <filesystem>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -169,16 +175,34 @@ struct TiledMapVisibleRegion
 };
 
 //------------------------------------------------------------------------------
+// Tile geometry never changes, so the layer is cut into square chunks that are baked into one GPU
+// vertex buffer per tileset texture at load. Drawing only submits the chunks overlapping the view
 class RenderableTileLayer
 {
     static constexpr uint32_t TILE_VERTEX_COUNT = 6;
+    static constexpr int32_t CHUNK_SIZE = 32;      // In tiles
+
+    struct TextureBatch
+    {
+        const sf::Texture* mTexture;
+        std::vector<sf::Vertex> mVertices;      // Only kept for drivers without vertex buffer support
+        sf::VertexBuffer mVertexBuffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Static };
+    };
+
+    struct TileChunk
+    {
+        std::vector<TextureBatch> mBatches;
+    };
 
 public:
-    RenderableTileLayer(TiledMap& tiledMap, tson::Layer& layer, const sf::Vector2u& windowSize)
+    RenderableTileLayer(TiledMap& tiledMap, tson::Layer& layer)
         : mTiledMap(tiledMap)
         , mLayer(layer)
+        , mChunkCountX((layer.getSize().x + CHUNK_SIZE - 1) / CHUNK_SIZE)
+        , mChunkCountY((layer.getSize().y + CHUNK_SIZE - 1) / CHUNK_SIZE)
+        , mChunks(static_cast<size_t>(mChunkCountX) * mChunkCountY)
     {
-        mTileVertices.resize(layer.getSize().x * layer.getSize().y * TILE_VERTEX_COUNT);
+        sf::Vector2f tileSize = tiledMap.GetTileSize();
         for (int32_t tileY = 0; tileY < layer.getSize().y; tileY++)
         {
             for (int32_t tileX = 0; tileX < layer.getSize().x; tileX++)
@@ -189,116 +213,121 @@ public:
                     continue;
                 }
 
-                tson::Tile* tile = layer.getTileObject(tileX, tileY)->getTile();
+                tson::Tile* tile = tileObject->getTile();
                 sf::FloatRect textureRegion = ConvertToSFMLRect<float>(tile->getDrawingRect());
                 
-                size_t index = (tileX + tileY * mLayer.getSize().x) * TILE_VERTEX_COUNT;
-                sf::Vector2f tileSize = tiledMap.GetTileSize();
+                TileChunk& chunk = mChunks[(tileX / CHUNK_SIZE) + (tileY / CHUNK_SIZE) * mChunkCountX];
+                std::vector<sf::Vertex>& vertices = GetBatch(chunk, &mTiledMap.GetTexture(tile->getGid())).mVertices;
+                size_t index = vertices.size();
+                vertices.resize(index + TILE_VERTEX_COUNT);
 
                 // Position
-                mTileVertices[index + 0].position = { tileX * tileSize.x, tileY * tileSize.y };
-                mTileVertices[index + 1].position = { (tileX + 1) * tileSize.x, tileY * tileSize.y };
-                mTileVertices[index + 2].position = { tileX * tileSize.x, (tileY + 1) * tileSize.y };
+                vertices[index + 0].position = { tileX * tileSize.x, tileY * tileSize.y };
+                vertices[index + 1].position = { (tileX + 1) * tileSize.x, tileY * tileSize.y };
+                vertices[index + 2].position = { tileX * tileSize.x, (tileY + 1) * tileSize.y };
 
-                mTileVertices[index + 3].position = { tileX * tileSize.x, (tileY + 1) * tileSize.y };
-                mTileVertices[index + 4].position = { (tileX + 1) * tileSize.x, tileY * tileSize.y };
-                mTileVertices[index + 5].position = { (tileX + 1) * tileSize.x, (tileY + 1) * tileSize.y };
+                vertices[index + 3].position = { tileX * tileSize.x, (tileY + 1) * tileSize.y };
+                vertices[index + 4].position = { (tileX + 1) * tileSize.x, tileY * tileSize.y };
+                vertices[index + 5].position = { (tileX + 1) * tileSize.x, (tileY + 1) * tileSize.y };
 
                 // Texture coordinates
-                mTileVertices[index + 0].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top);
-                mTileVertices[index + 1].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top);
-                mTileVertices[index + 2].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top + textureRegion.height);
-
-                mTileVertices[index + 3].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top + textureRegion.height);
-                mTileVertices[index + 4].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top);
-                mTileVertices[index + 5].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top + textureRegion.height);
-         
-                // Optimisation
-                sf::Texture* texture = const_cast<sf::Texture*>(&mTiledMap.GetTexture(tile->getGid()));
-                mLayerVertices[texture].reserve(GetVertexReserveSize(windowSize));
+                vertices[index + 0].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top);
+                vertices[index + 1].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top);
+                vertices[index + 2].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top + textureRegion.height);
+
+                vertices[index + 3].texCoords = sf::Vector2f(textureRegion.left, textureRegion.top + textureRegion.height);
+                vertices[index + 4].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top);
+                vertices[index + 5].texCoords = sf::Vector2f(textureRegion.left + textureRegion.width, textureRegion.top + textureRegion.height);
             }
-        }        
-    }
+        }
 
-    size_t GetVertexReserveSize(const sf::Vector2u& windowSize)
-    {
-        uint32_t maxHortTiles = windowSize.x / static_cast<uint32_t>(mTiledMap.GetTileSize().x);
-        uint32_t maxVertTiles = windowSize.y / static_cast<uint32_t>(mTiledMap.GetTileSize().y);
-        return maxHortTiles * maxVertTiles * TILE_VERTEX_COUNT;
+        BakeVertexBuffers();
     }
 
     void Draw(sf::RenderWindow& window, const TiledMapVisibleRegion& visibleRegion)
     {
-        for (auto& [_, vertices] : mLayerVertices)
+        int32_t startX = std::max(visibleRegion.mStartX, 0);
+        int32_t startY = std::max(visibleRegion.mStartY, 0);
+        int32_t endX = std::min(visibleRegion.mEndX, static_cast<int32_t>(mLayer.getSize().x));
+        int32_t endY = std::min(visibleRegion.mEndY, static_cast<int32_t>(mLayer.getSize().y));
+        if (startX >= endX || startY >= endY)
         {
-            vertices.clear();
+            return;
         }
 
-        // Iterate over the visible region
-        for (int32_t tileY = visibleRegion.mStartY; tileY < visibleRegion.mEndY; ++tileY)
+        // Chunks are drawn whole, the GPU clips the tiles hanging off screen
+        for (int32_t chunkY = startY / CHUNK_SIZE; chunkY <= (endY - 1) / CHUNK_SIZE; chunkY++)
         {
-            for (int32_t tileX = visibleRegion.mStartX; tileX < visibleRegion.mEndX;)
+            for (int32_t chunkX = startX / CHUNK_SIZE; chunkX <= (endX - 1) / CHUNK_SIZE; chunkX++)
             {
-                tson::TileObject* tileObject = mLayer.getTileObject(tileX, tileY);
-                if (!tileObject)
+                for (const TextureBatch& batch : mChunks[chunkX + chunkY * mChunkCountX].mBatches)
                 {
-                    ++tileX; // Move to the next tile if the current one is empty
-                    continue;
-                }
-
-                tson::Tile* tile = tileObject->getTile();
-                sf::Texture* texture = const_cast<sf::Texture*>(&mTiledMap.GetTexture(tile->getGid()));
-
-                // Start batching from this tile
-                size_t startIndex = (tileX + tileY * mLayer.getSize().x) * TILE_VERTEX_COUNT;
-                size_t endIndex = startIndex + TILE_VERTEX_COUNT; // Initially assume only one tile in the batch
-
-                // Attempt to batch consecutive tiles with the same texture
-                int32_t nextTileX = tileX + 1;
-                while (nextTileX < visibleRegion.mEndX)
-                {
-                    tson::TileObject* nextTileObject = mLayer.getTileObject(nextTileX, tileY);
-                    if (!nextTileObject || const_cast<sf::Texture*>(&mTiledMap.GetTexture(nextTileObject->getTile()->getGid())) != texture)
+                    sf::RenderStates renderStates;
+                    renderStates.texture = batch.mTexture;
+                    if (mIsVertexBufferAvailable)
                     {
-                        break; // End batch if the next tile is different or empty
+                        window.draw(batch.mVertexBuffer, renderStates);
+                    }
+                    else
+                    {
+                        window.draw(batch.mVertices.data(), batch.mVertices.size(), sf::PrimitiveType::Triangles, renderStates);
                     }
-
-                    endIndex += TILE_VERTEX_COUNT; // Extend the batch
-                    ++nextTileX;
                 }
+            }
+        }
+    }
 
-                // Insert all vertices of the batched tiles at once
-                std::vector<sf::Vertex>& layerVertices = mLayerVertices[texture];
-                layerVertices.insert(layerVertices.end(), mTileVertices.begin() + startIndex, mTileVertices.begin() + endIndex);
-
-                tileX = nextTileX; // Continue from the tile next to the batch
+private:
+    // Chunks use one or two tilesets, a flat list beats hashing
+    TextureBatch& GetBatch(TileChunk& chunk, const sf::Texture* texture)
+    {
+        for (TextureBatch& batch : chunk.mBatches)
+        {
+            if (batch.mTexture == texture)
+            {
+                return batch;
             }
         }
 
-        // Draw all batched tiles
-        for (auto& [texture, vertices] : mLayerVertices)
+        chunk.mBatches.push_back({ texture });
+        return chunk.mBatches.back();
+    }
+
+    // Uploaded once, after which the CPU copies are dropped
+    void BakeVertexBuffers()
+    {
+        mIsVertexBufferAvailable = sf::VertexBuffer::isAvailable();
+        if (!mIsVertexBufferAvailable)
         {
-            if (!vertices.empty())
+            return;
+        }
+
+        for (TileChunk& chunk : mChunks)
+        {
+            for (TextureBatch& batch : chunk.mBatches)
             {
-                sf::RenderStates renderStates;
-                renderStates.texture = texture;
-                window.draw(&vertices[0], vertices.size(), sf::PrimitiveType::Triangles, renderStates);
+                if (!batch.mVertexBuffer.create(batch.mVertices.size()) || !batch.mVertexBuffer.update(batch.mVertices.data()))
+                {
+                    throw std::runtime_error("Failed to create tile layer vertex buffer");
+                }
+                std::vector<sf::Vertex>().swap(batch.mVertices);
             }
         }
     }
 
-private:
     TiledMap& mTiledMap;
     tson::Layer& mLayer;
-    std::vector<sf::Vertex> mTileVertices;
-    std::unordered_map<sf::Texture*, std::vector<sf::Vertex>> mLayerVertices;
+    int32_t mChunkCountX;
+    int32_t mChunkCountY;
+    std::vector<TileChunk> mChunks;
+    bool mIsVertexBufferAvailable = false;
 };
 
 //------------------------------------------------------------------------------
 class TiledMapLayerRenderer
 {    
 public:
-    TiledMapLayerRenderer(TiledMap& tiledMap, const sf::Vector2u& windowSize)
+    TiledMapLayerRenderer(TiledMap& tiledMap)
         : mTiledMap(tiledMap)
         , mShouldRenderLayer(tiledMap.LayerCount(), false)
     { 
@@ -307,7 +336,7 @@ public:
             tson::Layer& layer = tiledMap.GetLayer(index);
             if (layer.getType() == tson::LayerType::TileLayer)
             {
-                mTileLayers.emplace(index, RenderableTileLayer(tiledMap, layer, windowSize));
+                mTileLayers.emplace(std::piecewise_construct, std::forward_as_tuple(index), std::forward_as_tuple(tiledMap, layer));
             }
         }
     }
@@ -359,66 +388,346 @@ private:
 };
 
 //------------------------------------------------------------------------------
-class Tile : public GameObject
+struct TileRaycastHit
 {
-public:
-    Tile(tson::Tile& tile, const sf::Vector2f& position, const sf::Vector2f& size)
-        : mTile(tile)
-        , mBounds(position, size)
-    { }
-
-    virtual FloatRect GetGlobalBounds() const 
-    { 
-        return mBounds; 
-    }
-
-    virtual const sf::Vector2f GetVelocity() const 
-    { 
-        return sf::Vector2f(); 
-    }
-
-private:
-    FloatRect mBounds;
-    tson::Tile& mTile;
+    sf::Vector2f mPosition;
+    sf::Vector2f mNormal;   // Face of the cell the ray entered through, zero when the ray starts inside it
+    float mDistance;
+    sf::Vector2i mCell;
 };
 
 //------------------------------------------------------------------------------
 class TiledLayerSpatialQuery
 {
+    static constexpr uint32_t NO_COLLIDER = std::numeric_limits<uint32_t>::max();
+
 public:
     TiledLayerSpatialQuery(tson::Layer& tileLayer)
-        : mTileData(tileLayer.getTileData())
+        : mGridSize(tileLayer.getSize().x, tileLayer.getSize().y)
         , mTileSize(ConvertToSFMLVector2f(tileLayer.getMap()->getTileSize()))
+        , mTileGids(static_cast<size_t>(mGridSize.x) * mGridSize.y, 0)
+        , mCellColliders(mTileGids.size(), NO_COLLIDER)
+        , mQueryStamp(0)
     {
         assert(tileLayer.getType() == tson::LayerType::TileLayer);
+
+        for (const auto& [key, tile] : tileLayer.getTileData())
+        {
+            auto [tileX, tileY] = key;
+            if (tile && IsInGrid(tileX, tileY))
+            {
+                mTileGids[GetCellIndex(tileX, tileY)] = tile->getGid();
+            }
+        }
+
+        MergeColliders();
     }
 
-    const std::vector<Tile>& QueryRegion(const sf::FloatRect& region) const
+    // Zero for empty or out of map cells
+    uint32_t GetTileGid(int32_t tileX, int32_t tileY) const
     {
-        int32_t startX = static_cast<int32_t>(std::floor(region.left / mTileSize.x));
-        int32_t startY = static_cast<int32_t>(std::floor(region.top / mTileSize.y));
-        int32_t endX = static_cast<int32_t>(std::ceil((region.left + region.width) / mTileSize.x));
-        int32_t endY = static_cast<int32_t>(std::ceil((region.top + region.height) / mTileSize.y));
+        return IsInGrid(tileX, tileY) ? mTileGids[GetCellIndex(tileX, tileY)] : 0;
+    }
 
-        mQueryResult.clear();
-        for (int32_t tileY = startY; tileY < endY; tileY++)
+    bool IsSolid(int32_t tileX, int32_t tileY) const
+    {
+        return GetTileGid(tileX, tileY) != 0;
+    }
+
+    const sf::Vector2f& GetTileSize() const
+    {
+        return mTileSize;
+    }
+
+    // Clamped range of cells the region touches, empty when the region lies outside the map
+    sf::IntRect GetCellRange(const sf::FloatRect& region) const
+    {
+        int32_t startX = std::max(static_cast<int32_t>(std::floor(region.left / mTileSize.x)), 0);
+        int32_t startY = std::max(static_cast<int32_t>(std::floor(region.top / mTileSize.y)), 0);
+        int32_t endX = std::min(static_cast<int32_t>(std::ceil((region.left + region.width) / mTileSize.x)), mGridSize.x);
+        int32_t endY = std::min(static_cast<int32_t>(std::ceil((region.top + region.height) / mTileSize.y)), mGridSize.y);
+
+        return sf::IntRect({ startX, startY }, { std::max(endX - startX, 0), std::max(endY - startY, 0) });
+    }
+
+    template<typename Function>
+    void ForEachTileInRegion(const sf::FloatRect& region, Function&& function) const
+    {
+        sf::IntRect cellRange = GetCellRange(region);
+        for (int32_t tileY = cellRange.top; tileY < cellRange.top + cellRange.height; tileY++)
         {
-            for (int32_t tileX = startX; tileX < endX; tileX++)
-            {                
-                std::tuple<int32_t, int32_t> key = { tileX, tileY };
-                if (mTileData.find(key) != mTileData.end())
+            for (int32_t tileX = cellRange.left; tileX < cellRange.left + cellRange.width; tileX++)
+            {
+                if (mTileGids[GetCellIndex(tileX, tileY)] != 0)
                 {
                     sf::Vector2f position(tileX * mTileSize.x, tileY * mTileSize.y);
-                    mQueryResult.emplace_back(*mTileData.at(key), position, mTileSize);
+                    function(FloatRect(position, mTileSize));
                 }
             }
         }
+    }
 
+    // The result is reused between calls and stays valid until the next query
+    const std::vector<FloatRect>& QueryRegion(const sf::FloatRect& region) const
+    {
+        mQueryResult.clear();
+        ForEachTileInRegion(region, [this](const FloatRect& tileBounds)
+        {
+            mQueryResult.push_back(tileBounds);
+        });
         return mQueryResult;
     }
 
+    // Visits each merged collider touching the region once, in the order its first cell is found
+    template<typename Function>
+    void ForEachColliderInRegion(const sf::FloatRect& region, Function&& function) const
+    {
+        ++mQueryStamp;
+
+        sf::IntRect cellRange = GetCellRange(region);
+        for (int32_t tileY = cellRange.top; tileY < cellRange.top + cellRange.height; tileY++)
+        {
+            for (int32_t tileX = cellRange.left; tileX < cellRange.left + cellRange.width; tileX++)
+            {
+                uint32_t colliderIndex = mCellColliders[GetCellIndex(tileX, tileY)];
+                if (colliderIndex != NO_COLLIDER && mColliderQueryStamps[colliderIndex] != mQueryStamp)
+                {
+                    mColliderQueryStamps[colliderIndex] = mQueryStamp;
+                    function(mColliders[colliderIndex]);
+                }
+            }
+        }
+    }
+
+    // The result is reused between calls and stays valid until the next query
+    const std::vector<FloatRect>& QueryColliders(const sf::FloatRect& region) const
+    {
+        mQueryResult.clear();
+        ForEachColliderInRegion(region, [this](const FloatRect& colliderBounds)
+        {
+            mQueryResult.push_back(colliderBounds);
+        });
+        return mQueryResult;
+    }
+
+    // Earliest time of impact of the moving box against the merged colliders along its displacement
+    std::optional<float> SweepColliders(const FloatRect& moving, const sf::Vector2f& displacement) const
+    {
+        std::optional<float> timeOfImpact;
+        ForEachColliderInRegion(GetSweptBounds(moving, displacement), [&](const FloatRect& colliderBounds)
+        {
+            std::optional<float> colliderTimeOfImpact = SweepRect(moving, displacement, colliderBounds);
+            if (colliderTimeOfImpact && (!timeOfImpact || *colliderTimeOfImpact < *timeOfImpact))
+            {
+                timeOfImpact = colliderTimeOfImpact;
+            }
+        });
+        return timeOfImpact;
+    }
+
+    // First solid cell along the ray within maxDistance, the direction does not need to be normalized
+    std::optional<TileRaycastHit> Raycast(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const
+    {
+        float length = direction.length();
+        if (length == 0.0f)
+        {
+            return std::nullopt;
+        }
+        return TraverseCells(origin, direction / length, maxDistance);
+    }
+
+    std::optional<TileRaycastHit> RaycastSegment(const sf::Vector2f& start, const sf::Vector2f& end) const
+    {
+        return Raycast(start, end - start, (end - start).length());
+    }
+
+    bool IsSegmentBlocked(const sf::Vector2f& start, const sf::Vector2f& end) const
+    {
+        return RaycastSegment(start, end).has_value();
+    }
+
+    const std::vector<FloatRect>& GetColliders() const
+    {
+        return mColliders;
+    }
+
+    bool IsRegionOccupied(const sf::FloatRect& region) const
+    {
+        sf::IntRect cellRange = GetCellRange(region);
+        for (int32_t tileY = cellRange.top; tileY < cellRange.top + cellRange.height; tileY++)
+        {
+            for (int32_t tileX = cellRange.left; tileX < cellRange.left + cellRange.width; tileX++)
+            {
+                if (mTileGids[GetCellIndex(tileX, tileY)] != 0)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
 private:
-    const std::map<std::tuple<int32_t, int32_t>, tson::Tile*> mTileData;
+    // Amanatides-Woo traversal: steps cell by cell along the ray, always crossing whichever cell
+    // boundary is nearer, so only the cells the ray actually passes through are visited
+    std::optional<TileRaycastHit> TraverseCells(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance) const
+    {
+        constexpr float INFINITE_DISTANCE = std::numeric_limits<float>::infinity();
+
+        // Clip the ray to the map so traversal starts at the first cell in the grid
+        sf::Vector2f mapSize(mGridSize.x * mTileSize.x, mGridSize.y * mTileSize.y);
+        float startDistance = 0.0f;
+        float endDistance = maxDistance;
+        sf::Vector2f normal;
+        for (int32_t axis = 0; axis < 2; axis++)
+        {
+            float axisOrigin = axis == 0 ? origin.x : origin.y;
+            float axisDirection = axis == 0 ? direction.x : direction.y;
+            float axisSize = axis == 0 ? mapSize.x : mapSize.y;
+            if (axisDirection == 0.0f)
+            {
+                if (axisOrigin < 0.0f || axisOrigin >= axisSize)
+                {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            float entryDistance = ((axisDirection > 0.0f ? 0.0f : axisSize) - axisOrigin) / axisDirection;
+            float exitDistance = ((axisDirection > 0.0f ? axisSize : 0.0f) - axisOrigin) / axisDirection;
+            if (entryDistance > startDistance)
+            {
+                startDistance = entryDistance;
+                normal = axis == 0 ? sf::Vector2f(axisDirection > 0.0f ? -1.0f : 1.0f, 0.0f)
+                                   : sf::Vector2f(0.0f, axisDirection > 0.0f ? -1.0f : 1.0f);
+            }
+            endDistance = std::min(endDistance, exitDistance);
+        }
+        if (startDistance > endDistance)
+        {
+            return std::nullopt;
+        }
+
+        sf::Vector2f start = origin + direction * startDistance;
+        sf::Vector2i cell(std::clamp(static_cast<int32_t>(std::floor(start.x / mTileSize.x)), 0, mGridSize.x - 1),
+                          std::clamp(static_cast<int32_t>(std::floor(start.y / mTileSize.y)), 0, mGridSize.y - 1));
+        sf::Vector2i step(direction.x > 0.0f ? 1 : (direction.x < 0.0f ? -1 : 0),
+                          direction.y > 0.0f ? 1 : (direction.y < 0.0f ? -1 : 0));
+
+        // Distance along the ray to cross one whole cell, and to reach the next boundary on each axis
+        sf::Vector2f deltaDistance(step.x != 0 ? mTileSize.x / std::abs(direction.x) : INFINITE_DISTANCE,
+                                   step.y != 0 ? mTileSize.y / std::abs(direction.y) : INFINITE_DISTANCE);
+        sf::Vector2f boundaryDistance(
+            step.x != 0 ? startDistance + ((cell.x + (step.x > 0 ? 1 : 0)) * mTileSize.x - start.x) / direction.x : INFINITE_DISTANCE,
+            step.y != 0 ? startDistance + ((cell.y + (step.y > 0 ? 1 : 0)) * mTileSize.y - start.y) / direction.y : INFINITE_DISTANCE);
+
+        float distance = startDistance;
+        while (true)
+        {
+            if (mTileGids[GetCellIndex(cell.x, cell.y)] != 0)
+            {
+                return TileRaycastHit{ origin + direction * distance, normal, distance, cell };
+            }
+
+            if (boundaryDistance.x < boundaryDistance.y)
+            {
+                distance = boundaryDistance.x;
+                boundaryDistance.x += deltaDistance.x;
+                cell.x += step.x;
+                normal = sf::Vector2f(static_cast<float>(-step.x), 0.0f);
+            }
+            else
+            {
+                distance = boundaryDistance.y;
+                boundaryDistance.y += deltaDistance.y;
+                cell.y += step.y;
+                normal = sf::Vector2f(0.0f, static_cast<float>(-step.y));
+            }
+
+            if (distance > endDistance || !IsInGrid(cell.x, cell.y))
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    // Greedily grows each unclaimed solid cell into the widest run, then extends the run down while
+    // the whole row below is solid, so long floors and walls collapse into single rectangles
+    void MergeColliders()
+    {
+        for (int32_t tileY = 0; tileY < mGridSize.y; tileY++)
+        {
+            for (int32_t tileX = 0; tileX < mGridSize.x; tileX++)
+            {
+                if (!IsUnclaimedSolid(tileX, tileY))
+                {
+                    continue;
+                }
+
+                int32_t width = 1;
+                while (tileX + width < mGridSize.x && IsUnclaimedSolid(tileX + width, tileY))
+                {
+                    ++width;
+                }
+
+                int32_t height = 1;
+                while (tileY + height < mGridSize.y && IsUnclaimedSolidRun(tileX, tileY + height, width))
+                {
+                    ++height;
+                }
+
+                uint32_t colliderIndex = static_cast<uint32_t>(mColliders.size());
+                for (int32_t y = tileY; y < tileY + height; y++)
+                {
+                    for (int32_t x = tileX; x < tileX + width; x++)
+                    {
+                        mCellColliders[GetCellIndex(x, y)] = colliderIndex;
+                    }
+                }
+
+                sf::Vector2f position(tileX * mTileSize.x, tileY * mTileSize.y);
+                sf::Vector2f size(width * mTileSize.x, height * mTileSize.y);
+                mColliders.emplace_back(position, size);
+            }
+        }
+
+        mColliderQueryStamps.assign(mColliders.size(), 0);
+    }
+
+    bool IsUnclaimedSolid(int32_t tileX, int32_t tileY) const
+    {
+        size_t index = GetCellIndex(tileX, tileY);
+        return mTileGids[index] != 0 && mCellColliders[index] == NO_COLLIDER;
+    }
+
+    bool IsUnclaimedSolidRun(int32_t tileX, int32_t tileY, int32_t width) const
+    {
+        for (int32_t x = tileX; x < tileX + width; x++)
+        {
+            if (!IsUnclaimedSolid(x, tileY))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsInGrid(int32_t tileX, int32_t tileY) const
+    {
+        return 0 <= tileX && tileX < mGridSize.x && 0 <= tileY && tileY < mGridSize.y;
+    }
+
+    size_t GetCellIndex(int32_t tileX, int32_t tileY) const
+    {
+        return static_cast<size_t>(tileY) * mGridSize.x + tileX;
+    }
+
+    sf::Vector2i mGridSize;
     sf::Vector2f mTileSize;
-    mutable std::vector<Tile> mQueryResult;
+    std::vector<uint32_t> mTileGids;
+    std::vector<uint32_t> mCellColliders;
+    std::vector<FloatRect> mColliders;
+    mutable std::vector<uint32_t> mColliderQueryStamps;
+    mutable uint32_t mQueryStamp;
+    mutable std::vector<FloatRect> mQueryResult;
 };
\ No newline at end of file